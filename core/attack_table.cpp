@@ -0,0 +1,44 @@
+#include "attack_table.hpp"
+
+namespace tetris {
+
+AttackTable AttackTable::guideline() {
+  AttackTable table{};
+  table.clearAttack = {{
+      {0, 0, 1, 2, 4}, // No T-spin
+      {0, 2, 4, 6, 6}, // T-spin
+      {0, 0, 1, 1, 1}, // T-spin mini
+  }};
+  table.comboAttack = {0, 1, 1, 2, 2, 3, 3, 4, 4, 4, 5, 5, 5};
+  table.backToBackBonus = 1;
+  table.perfectClearAttack = 10;
+  return table;
+}
+
+AttackTable AttackTable::tetrio() {
+  AttackTable table{};
+  table.clearAttack = {{
+      {0, 0, 1, 2, 4}, // No T-spin
+      {0, 2, 4, 6, 6}, // T-spin
+      {0, 0, 1, 1, 1}, // T-spin mini
+  }};
+  table.comboAttack = {0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 2, 3, 3};
+  table.backToBackBonus = 1;
+  table.perfectClearAttack = 10;
+  return table;
+}
+
+AttackTable AttackTable::jstris() {
+  AttackTable table{};
+  table.clearAttack = {{
+      {0, 0, 1, 2, 4}, // No T-spin
+      {0, 2, 4, 6, 6}, // T-spin
+      {0, 0, 1, 2, 2}, // T-spin mini
+  }};
+  table.comboAttack = {0, 0, 1, 1, 1, 2, 2, 3, 3, 4, 4, 4, 5};
+  table.backToBackBonus = 1;
+  table.perfectClearAttack = 10;
+  return table;
+}
+
+} // namespace tetris
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "placement.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace tetris {
+
+/**
+ * @brief Largest number of rows a single placement can clear
+ */
+constexpr int32_t maxLinesPerClear{4};
+
+/**
+ * @brief Number of T-spin types (0=None, 1=T-Spin, 2=T-Spin Mini)
+ */
+constexpr int32_t tSpinTypeCount{3};
+
+/**
+ * @brief Outcome of a placement in terms of attack
+ */
+struct AttackResult {
+  int32_t attack{0};       ///< Garbage lines sent by the placement
+  int32_t combo{0};        ///< Consecutive clearing placements, this included
+  bool backToBack{false};  ///< Whether a back-to-back chain is active after it
+  bool perfectClear{false}; ///< Whether the placement emptied the board
+};
+
+/**
+ * @brief Attack rules of a game, as lookup tables
+ *
+ * Every quantity is indexed by integers taken from the placement, so
+ * computing the attack of a placement needs no branching on the rule set.
+ */
+struct AttackTable {
+  /**
+   * @brief Number of entries in the combo table, longer chains use the last
+   */
+  static constexpr size_t comboTableSize{13};
+
+  /**
+   * @brief Attack of a clear, indexed by [tSpinType][linesCleared]
+   */
+  std::array<std::array<int32_t, maxLinesPerClear + 1>, tSpinTypeCount>
+      clearAttack{};
+
+  /**
+   * @brief Extra attack per combo, indexed by (combo - 1)
+   */
+  std::array<int32_t, comboTableSize> comboAttack{};
+
+  int32_t backToBackBonus{0};    ///< Extra attack of a back-to-back clear
+  int32_t perfectClearAttack{0}; ///< Extra attack of a perfect clear
+
+  /**
+   * @brief Attack rules of the Tetris guideline
+   */
+  [[nodiscard]] static AttackTable guideline();
+
+  /**
+   * @brief Attack rules of TETR.IO
+   *
+   * TETR.IO scales combos by the attack of the clear; the table uses the
+   * values for clears without base attack.
+   */
+  [[nodiscard]] static AttackTable tetrio();
+
+  /**
+   * @brief Attack rules of Jstris
+   */
+  [[nodiscard]] static AttackTable jstris();
+
+  /**
+   * @brief Compute the attack of a placement
+   *
+   * A clear is difficult if it clears four rows or is any T-spin clear;
+   * consecutive difficult clears earn the back-to-back bonus, other clears end
+   * the chain, and placements that clear nothing leave it untouched.
+   *
+   * @param placement The result of the placement
+   * @param combo The combo before the placement
+   * @param backToBack Whether a back-to-back chain was active before it
+   * @return The attack and the combo and back-to-back state after it
+   */
+  [[nodiscard]] AttackResult computeAttack(const PlacementResult& placement,
+                                           int32_t combo,
+                                           bool backToBack) const {
+    const int32_t lines{std::clamp(placement.linesCleared, 0,
+                                   maxLinesPerClear)};
+    const int32_t tSpinType{std::clamp(placement.tSpinType, 0,
+                                       tSpinTypeCount - 1)};
+    const bool cleared{lines > 0};
+    const bool difficult{cleared &&
+                         (lines == maxLinesPerClear || tSpinType != 0)};
+
+    AttackResult result{};
+    result.combo = cleared ? combo + 1 : 0;
+    result.backToBack = difficult || (backToBack && !cleared);
+    result.perfectClear = placement.perfectClear;
+
+    const auto comboIndex{static_cast<size_t>(
+        std::clamp<int32_t>(result.combo - 1, 0, comboTableSize - 1))};
+    result.attack =
+        clearAttack.at(tSpinType).at(lines) +
+        comboAttack.at(comboIndex) * static_cast<int32_t>(cleared) +
+        backToBackBonus * static_cast<int32_t>(difficult && backToBack) +
+        perfectClearAttack * static_cast<int32_t>(placement.perfectClear);
+
+    return result;
+  }
+};
+
+} // namespace tetris
@@ -0,0 +1,66 @@
+#include "bag_state.hpp"
+
+#include <bit>
+#include <utility>
+
+namespace tetris {
+
+BagState::BagState(const uint8_t remainingMask)
+    : m_remainingMask{static_cast<uint8_t>(remainingMask & fullMask)} {
+  if (m_remainingMask == 0) {
+    m_remainingMask = fullMask;
+  }
+}
+
+BagState BagState::fromSequence(const std::span<const PieceType> sequence) {
+  uint8_t possibleMask{0};
+
+  // The first bag boundary is one of the first seven positions; pieces
+  // before it end a bag that started before the sequence
+  for (size_t boundary{0}; boundary < pieceTypeCount; ++boundary) {
+    BagState bag{};
+    bool consistent{true};
+    for (size_t i{0}; i < sequence.size() && consistent; ++i) {
+      if (i == boundary) {
+        bag = BagState{};
+      }
+      consistent = bag.take(sequence[i]);
+    }
+    if (consistent) {
+      possibleMask |= bag.m_remainingMask;
+    }
+  }
+  return BagState{possibleMask};
+}
+
+int32_t BagState::getRemainingCount() const {
+  return std::popcount(m_remainingMask);
+}
+
+std::vector<PieceType> BagState::getRemainingPieces() const {
+  std::vector<PieceType> pieces{};
+  for (size_t i{0}; i < pieceTypeCount; ++i) {
+    const auto type{static_cast<PieceType>(i)};
+    if (contains(type)) {
+      pieces.push_back(type);
+    }
+  }
+  return pieces;
+}
+
+bool BagState::take(const PieceType type) {
+  if (!contains(type)) {
+    return false;
+  }
+  m_remainingMask &= static_cast<uint8_t>(~getPieceBit(type));
+  if (m_remainingMask == 0) {
+    m_remainingMask = fullMask;
+  }
+  return true;
+}
+
+uint8_t BagState::getPieceBit(const PieceType type) {
+  return static_cast<uint8_t>(1U << std::to_underlying(type));
+}
+
+} // namespace tetris
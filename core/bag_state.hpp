@@ -0,0 +1,93 @@
+#pragma once
+
+#include "tetris_piece.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace tetris {
+
+/**
+ * @class BagState
+ * @brief The pieces left in the current bag of a 7-bag randomizer
+ *
+ * The bag is a set of piece types stored as a bit mask, bit i standing for
+ * PieceType i. Taking the last piece starts a new full bag.
+ */
+class BagState {
+public:
+  /**
+   * @brief Mask of a bag holding every piece type
+   */
+  static constexpr uint8_t fullMask{(1U << pieceTypeCount) - 1U};
+
+  /**
+   * @brief Construct a full bag
+   */
+  BagState() = default;
+
+  /**
+   * @brief Construct a bag from a mask of remaining piece types
+   *
+   * @param remainingMask Bit i set if PieceType i is left, empty means full
+   */
+  explicit BagState(uint8_t remainingMask);
+
+  /**
+   * @brief Derive the bag left after a piece sequence
+   *
+   * The sequence does not say where bags start, so every bag boundary that
+   * splits it into bags without repeated pieces is considered and the pieces
+   * left by any of them are kept. With one consistent boundary the result is
+   * exact; a sequence no boundary explains, which a 7-bag randomizer cannot
+   * produce, gives a full bag.
+   *
+   * @param sequence The pieces in dealing order
+   * @return The bag after the last piece
+   */
+  [[nodiscard]] static BagState
+  fromSequence(std::span<const PieceType> sequence);
+
+  /**
+   * @brief Check whether a piece type is left in the bag
+   */
+  [[nodiscard]] bool contains(PieceType type) const {
+    return (m_remainingMask & getPieceBit(type)) != 0;
+  }
+
+  /**
+   * @brief Get the mask of remaining piece types
+   */
+  [[nodiscard]] uint8_t getRemainingMask() const { return m_remainingMask; }
+
+  /**
+   * @brief Get the number of remaining piece types
+   */
+  [[nodiscard]] int32_t getRemainingCount() const;
+
+  /**
+   * @brief Get the remaining piece types, in PieceType order
+   */
+  [[nodiscard]] std::vector<PieceType> getRemainingPieces() const;
+
+  /**
+   * @brief Remove a piece from the bag, refilling it once empty
+   *
+   * @param type The piece dealt
+   * @return false if the piece was not left in the bag; the bag is then
+   * unchanged
+   */
+  bool take(PieceType type);
+
+  bool operator==(const BagState& other) const = default;
+
+private:
+  /**
+   * @brief Get the mask bit of a piece type
+   */
+  [[nodiscard]] static uint8_t getPieceBit(PieceType type);
+
+  uint8_t m_remainingMask{fullMask}; ///< Bit i set if PieceType i is left
+};
+
+} // namespace tetris
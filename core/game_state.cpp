@@ -1,12 +1,42 @@
 #include "game_state.hpp"
+#include "attack_table.hpp"
 #include "move.hpp"
+#include "placement.hpp"
+#include "zobrist.hpp"
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <sstream>
 #include <stdexcept>
 
 namespace tetris {
 
+namespace {
+
+/**
+ * @brief Score of a clear at level 1, indexed by [tSpinType][linesCleared]
+ */
+constexpr std::array<std::array<int32_t, maxLinesPerClear + 1>, tSpinTypeCount>
+    clearScores{{
+        {0, 100, 300, 500, 800},      // No T-spin
+        {400, 800, 1200, 1600, 1600}, // T-spin
+        {100, 200, 400, 400, 400},    // T-spin mini
+    }};
+
+/**
+ * @brief Bonus of a perfect clear, indexed by linesCleared
+ */
+constexpr std::array<int32_t, maxLinesPerClear + 1> perfectClearScores{
+    0, 800, 1200, 1800, 2000};
+
+/**
+ * @brief Score per combo step
+ */
+constexpr int32_t comboScore{50};
+
+} // namespace
+
 GameState::GameState(const int32_t width, const int32_t height)
     : m_board{width, height} {}
 
@@ -127,17 +157,37 @@ bool GameState::applyMove(const Move& move) {
 }
 
 bool GameState::isValidState(const PieceState& state) const {
-  // Create a temporary piece with the new state
-  const Piece tempPiece(state, m_rotationSystem);
-
-  // Check if any of the piece's cells are out of bounds or collide with the
-  // board
-  return std::ranges::all_of(
-      tempPiece.getAbsoluteFilledCells(), [this](const auto& cell) {
-        const auto& [xPos, yPos] = cell;
-        return xPos >= 0 && xPos < m_board.getWidth() && yPos >= 0 &&
-               yPos < m_board.getHeight() && !m_board.isFilled(xPos, yPos);
-      });
+  [[unlikely]] if (!m_rotationSystem) {
+    throw std::invalid_argument("Rotation system cannot be null");
+  }
+
+  // Only the shape is needed, so no temporary piece is built
+  const auto shape{
+      m_rotationSystem->getShapeData(state.getType(), state.getRotation())};
+  const auto [xPos, yPos] = state.getPosition();
+
+  // Check the piece row by row against the bounds and the board row words,
+  // without building a list of cells
+  for (size_t y{0}; y < Piece::maxSize; ++y) {
+    // Shape bits are stored row-major with bit (y * maxSize + x)
+    const auto rowBits{static_cast<uint32_t>(
+        (shape >> (y * Piece::maxSize)).to_ulong() & 0xFU)};
+    if (rowBits == 0) {
+      continue;
+    }
+    const int32_t row{yPos + static_cast<int32_t>(y)};
+    const int32_t left{xPos + std::countr_zero(rowBits)};
+    const int32_t right{xPos + static_cast<int32_t>(std::bit_width(rowBits))};
+    if (row < 0 || row >= m_board.getHeight() || left < 0 ||
+        right > m_board.getWidth()) {
+      return false;
+    }
+    const uint32_t mask{xPos >= 0 ? rowBits << xPos : rowBits >> -xPos};
+    if ((m_board.getRow(row) & mask) != 0) {
+      return false;
+    }
+  }
+  return true;
 }
 
 bool GameState::checkCollision(const PieceState& state,
@@ -149,22 +199,53 @@ bool GameState::checkCollision(const PieceState& state,
   return !isValidState(tempState);
 }
 
-int32_t GameState::lockCurrentPiece() {
-  // Add the piece to the board
-  for (const auto& [xPos, yPos] : m_currentPiece.getAbsoluteFilledCells()) {
-    m_board.fillCell(xPos, yPos);
-  }
-
-  // Clear any filled rows
-  const int32_t linesCleared{m_board.clearFilledRows()};
+int32_t GameState::lockCurrentPiece(const int32_t tSpinType) {
+  // Add the piece to the board and clear any filled rows
+  m_lastPlacement = placePiece(m_board, m_currentPiece, tSpinType);
+  const int32_t linesCleared{m_lastPlacement.linesCleared};
   m_linesCleared += linesCleared;
 
+  // Combo, back-to-back and score come from table lookups and flags, so the
+  // update does not branch on the kind of clear
+  const int32_t lines{std::clamp(linesCleared, 0, maxLinesPerClear)};
+  const int32_t spin{std::clamp(tSpinType, 0, tSpinTypeCount - 1)};
+  const bool cleared{lines > 0};
+  const bool difficult{cleared && (lines == maxLinesPerClear || spin != 0)};
+  const int32_t clearScore{clearScores.at(spin).at(lines)};
+
+  m_score += clearScore +
+             clearScore / 2 * static_cast<int32_t>(difficult && m_backToBack) +
+             comboScore * m_combo * static_cast<int32_t>(cleared) +
+             perfectClearScores.at(lines) *
+                 static_cast<int32_t>(m_lastPlacement.perfectClear);
+  m_combo = (m_combo + 1) * static_cast<int32_t>(cleared);
+  m_backToBack = difficult || (m_backToBack && !cleared);
+
   // Reset hold usage
   m_holdUsed = false;
 
   return linesCleared;
 }
 
+void GameState::queueGarbage(const int32_t lines, const int32_t holeColumn) {
+  [[unlikely]] if (holeColumn < 0 || holeColumn >= m_board.getWidth()) {
+    throw std::invalid_argument("Garbage hole column outside the board");
+  }
+  m_garbageQueue.push(GarbageBatch{.lines = lines, .holeColumn = holeColumn});
+}
+
+int32_t GameState::receiveGarbage(const int32_t maxLines) {
+  int32_t inserted{0};
+  while (inserted < maxLines && !m_garbageQueue.empty()) {
+    const GarbageBatch batch{m_garbageQueue.take(maxLines - inserted)};
+    if (!m_board.insertGarbage(batch.lines, batch.holeColumn)) {
+      m_gameOver = true;
+    }
+    inserted += batch.lines;
+  }
+  return inserted;
+}
+
 bool GameState::spawnPiece(const PieceType type) {
   if (!m_rotationSystem) {
     throw std::runtime_error("Rotation system not set");
@@ -174,8 +255,13 @@ bool GameState::spawnPiece(const PieceType type) {
   const PieceState state{m_rotationSystem->getInitialState(
       type, m_board.getWidth(), m_board.getHeight())};
 
-  // Create a new piece with the state and rotation system
-  m_currentPiece = Piece(state, m_rotationSystem);
+  // Reuse the current piece when it already shares the rotation system,
+  // which saves copying the shared pointer on every spawn
+  if (m_currentPiece.getRotationSystem() == m_rotationSystem) {
+    m_currentPiece.setState(state);
+  } else {
+    m_currentPiece = Piece(state, m_rotationSystem);
+  }
 
   // Check if the piece can be placed without collisions
   if (!isValidState(state)) {
@@ -232,20 +318,25 @@ bool GameState::holdCurrentPiece() {
   return true;
 }
 
-GameState GameState::clone() const {
-  GameState copy{m_board.getWidth(), m_board.getHeight()};
-  copy.m_board = m_board;
-  copy.m_rotationSystem = m_rotationSystem;
-  copy.m_currentPiece = m_currentPiece;
-  copy.m_heldPiece = m_heldPiece;
-  copy.m_holdUsed = m_holdUsed;
-  copy.m_nextPieces = m_nextPieces;
-  copy.m_linesCleared = m_linesCleared;
-  copy.m_gameOver = m_gameOver;
-
-  return copy;
+uint64_t GameState::getHash() const {
+  uint64_t hash{m_board.getZobristKey()};
+  hash ^= getQueueKey(0, m_currentPiece.getState().getType());
+  for (size_t slot{1}; const PieceType type : m_nextPieces) {
+    hash ^= getQueueKey(slot++, type);
+  }
+  hash ^= getHoldKey(m_heldPiece);
+  if (m_holdUsed) {
+    hash ^= zobristHoldUsedKey;
+  }
+  hash ^= getComboKey(m_combo);
+  if (m_backToBack) {
+    hash ^= zobristBackToBackKey;
+  }
+  return hash;
 }
 
+GameState GameState::clone() const { return GameState{*this}; }
+
 std::string GameState::toString() const {
   std::ostringstream oss;
 
@@ -265,7 +356,11 @@ std::string GameState::toString() const {
     oss << static_cast<char>(piece) << " ";
   }
   oss << "\n";
+  oss << "  Incoming Garbage: " << m_garbageQueue.getTotalLines() << "\n";
   oss << "  Lines Cleared: " << m_linesCleared << "\n";
+  oss << "  Combo: " << m_combo << "\n";
+  oss << "  Back-to-Back: " << (m_backToBack ? "Yes" : "No") << "\n";
+  oss << "  Score: " << m_score << "\n";
   oss << "  Game Over: " << (m_gameOver ? "Yes" : "No") << "\n";
 
   return oss.str();
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "../rotation_systems/rotation_system.hpp"
+#include "garbage_queue.hpp"
+#include "piece_queue.hpp"
+#include "placement.hpp"
 #include "tetris_board.hpp"
 #include "tetris_piece.hpp"
-#include <deque>
 #include <memory>
 #include <optional>
 #include <string>
@@ -100,14 +102,14 @@ public:
   /**
    * @brief Get the next pieces in the queue
    */
-  [[nodiscard]] const std::deque<PieceType>& getNextPieces() const {
+  [[nodiscard]] const PieceQueue& getNextPieces() const {
     return m_nextPieces;
   }
 
   /**
    * @brief Get a mutable reference to the next pieces queue
    */
-  std::deque<PieceType>& getNextPieces() { return m_nextPieces; }
+  PieceQueue& getNextPieces() { return m_nextPieces; }
 
   /**
    * @brief Get the number of lines cleared
@@ -119,6 +121,44 @@ public:
    */
   void setLinesCleared(const int32_t lines) { m_linesCleared = lines; }
 
+  /**
+   * @brief Get the number of consecutive clearing placements, the last one
+   * included
+   */
+  [[nodiscard]] int32_t getCombo() const { return m_combo; }
+
+  /**
+   * @brief Set the number of consecutive clearing placements
+   */
+  void setCombo(const int32_t combo) { m_combo = combo; }
+
+  /**
+   * @brief Check whether a back-to-back chain is active
+   */
+  [[nodiscard]] bool isBackToBack() const { return m_backToBack; }
+
+  /**
+   * @brief Set whether a back-to-back chain is active
+   */
+  void setBackToBack(const bool backToBack) { m_backToBack = backToBack; }
+
+  /**
+   * @brief Get the score
+   */
+  [[nodiscard]] int64_t getScore() const { return m_score; }
+
+  /**
+   * @brief Set the score
+   */
+  void setScore(const int64_t score) { m_score = score; }
+
+  /**
+   * @brief Get the result of the last piece locked
+   */
+  [[nodiscard]] const PlacementResult& getLastPlacement() const {
+    return m_lastPlacement;
+  }
+
   /**
    * @brief Check if the game is over
    */
@@ -129,6 +169,50 @@ public:
    */
   void setGameOver(const bool gameOver) { m_gameOver = gameOver; }
 
+  /**
+   * @brief Get the incoming garbage
+   */
+  [[nodiscard]] const GarbageQueue& getGarbageQueue() const {
+    return m_garbageQueue;
+  }
+
+  /**
+   * @brief Get a mutable reference to the incoming garbage
+   */
+  GarbageQueue& getGarbageQueue() { return m_garbageQueue; }
+
+  /**
+   * @brief Queue garbage sent by the opponent
+   *
+   * @param lines The number of garbage rows
+   * @param holeColumn The empty column of the rows
+   * @throws std::invalid_argument if holeColumn is outside the board
+   * @throws std::length_error if the garbage queue is full
+   */
+  void queueGarbage(int32_t lines, int32_t holeColumn);
+
+  /**
+   * @brief Cancel incoming garbage with the attack of a placement
+   *
+   * @param attack The attack of the placement
+   * @return The attack left to send to the opponent
+   */
+  int32_t cancelGarbage(const int32_t attack) {
+    return m_garbageQueue.cancel(attack);
+  }
+
+  /**
+   * @brief Push queued garbage into the board, oldest first
+   *
+   * Meant to be called after a piece locks without clearing and before the
+   * next piece spawns. The game is over if filled cells are pushed past the
+   * top of the board.
+   *
+   * @param maxLines The most rows to insert
+   * @return The number of rows inserted
+   */
+  int32_t receiveGarbage(int32_t maxLines);
+
   /**
    * @brief Apply a move to the current piece
    *
@@ -158,9 +242,16 @@ public:
   /**
    * @brief Lock the current piece into the board
    *
+   * Updates the combo, back-to-back chain and score from the lines cleared
+   * and the spin. Scores follow the guideline at level 1: the clear and spin
+   * score, half again for a back-to-back clear, 50 per combo step and a
+   * perfect clear bonus.
+   *
+   * @param tSpinType T-spin type of the placement (0=None, 1=T-Spin,
+   * 2=T-Spin Mini)
    * @return The number of lines cleared
    */
-  int32_t lockCurrentPiece();
+  int32_t lockCurrentPiece(int32_t tSpinType = 0);
 
   /**
    * @brief Spawn a new piece
@@ -186,9 +277,23 @@ public:
    */
   bool holdCurrentPiece();
 
+  /**
+   * @brief Get the Zobrist hash of the state
+   *
+   * Combines the board, the current piece type, the preview, the held piece
+   * and whether hold was used, so states that play out identically share a
+   * hash.
+   *
+   * @return The hash of the state
+   */
+  [[nodiscard]] uint64_t getHash() const;
+
   /**
    * @brief Create a deep copy of the game state
    *
+   * The board and queue are stored inline, so the copy allocates nothing;
+   * the rotation system is shared.
+   *
    * @return A new game state object that is a copy of this one
    */
   [[nodiscard]] GameState clone() const;
@@ -213,8 +318,13 @@ private:
   Piece m_currentPiece;                 ///< The current active piece
   std::optional<PieceType> m_heldPiece; ///< The held piece, if any
   bool m_holdUsed{false}; ///< Whether hold has been used in the current turn
-  std::deque<PieceType> m_nextPieces; ///< Queue of upcoming pieces
+  PieceQueue m_nextPieces;            ///< Queue of upcoming pieces
+  GarbageQueue m_garbageQueue;        ///< Incoming garbage, oldest first
   int32_t m_linesCleared{0};          ///< Total number of lines cleared
+  int32_t m_combo{0};                 ///< Consecutive clearing placements
+  bool m_backToBack{false};           ///< Whether a back-to-back is active
+  int64_t m_score{0};                 ///< Score
+  PlacementResult m_lastPlacement;    ///< Result of the last piece locked
   bool m_gameOver{false};             ///< Whether the game is over
   std::shared_ptr<RotationSystem>
       m_rotationSystem; ///< The rotation system to use
@@ -0,0 +1,112 @@
+#include "game_state_snapshot.hpp"
+#include "zobrist.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace tetris {
+
+GameStateSnapshot GameStateSnapshot::fromGameState(const GameState& gameState) {
+  const Board& board{gameState.getBoard()};
+  [[unlikely]] if (board.getWidth() > maxSnapshotWidth) {
+    throw std::invalid_argument("Board too wide for a snapshot");
+  }
+
+  GameStateSnapshot snapshot{};
+  snapshot.m_boardKey = board.getZobristKey();
+  for (int32_t row{0}; row < board.getRoof(); ++row) {
+    snapshot.m_rows.at(row) = static_cast<uint16_t>(board.getRow(row));
+  }
+  snapshot.m_queue = gameState.getNextPieces();
+  snapshot.m_linesCleared = gameState.getLinesCleared();
+  snapshot.m_combo = static_cast<int16_t>(gameState.getCombo());
+
+  const PieceState& piece{gameState.getCurrentPiece().getState()};
+  snapshot.m_pieceX = static_cast<int8_t>(piece.getPosition().xPos);
+  snapshot.m_pieceY = static_cast<int8_t>(piece.getPosition().yPos);
+  snapshot.m_pieceType = static_cast<uint8_t>(std::to_underlying(piece.getType()));
+  snapshot.m_pieceRotation =
+      static_cast<uint8_t>(std::to_underlying(piece.getRotation()));
+
+  const std::optional<PieceType> held{gameState.getHeldPiece()};
+  snapshot.m_heldPiece =
+      held.has_value() ? static_cast<uint8_t>(std::to_underlying(*held))
+                       : noPiece;
+  snapshot.m_flags =
+      static_cast<uint8_t>((gameState.isHoldUsed() ? holdUsedFlag : 0U) |
+                           (gameState.isBackToBack() ? backToBackFlag : 0U) |
+                           (gameState.isGameOver() ? gameOverFlag : 0U));
+  snapshot.m_width = static_cast<uint8_t>(board.getWidth());
+  snapshot.m_height = static_cast<uint8_t>(board.getHeight());
+  return snapshot;
+}
+
+void GameStateSnapshot::applyTo(GameState& gameState) const {
+  Board& board{gameState.getBoard()};
+  [[unlikely]] if (board.getWidth() != m_width ||
+                   board.getHeight() != m_height) {
+    throw std::invalid_argument("Snapshot board size differs from the state");
+  }
+
+  // Rebuilding through fillRowCells keeps heights and the key in step
+  board = Board{m_width, m_height};
+  for (int32_t row{0}; row < m_height; ++row) {
+    if (m_rows.at(row) != 0) {
+      board.fillRowCells(row, m_rows.at(row));
+    }
+  }
+
+  gameState.getCurrentPiece() =
+      Piece{getCurrentPiece(), gameState.getRotationSystem()};
+  gameState.setHeldPiece(getHeldPiece());
+  gameState.setHoldUsed(isHoldUsed());
+  gameState.getNextPieces() = m_queue;
+  gameState.setLinesCleared(m_linesCleared);
+  gameState.setCombo(m_combo);
+  gameState.setBackToBack(isBackToBack());
+  gameState.setGameOver(isGameOver());
+}
+
+GameState GameStateSnapshot::toGameState(
+    std::shared_ptr<RotationSystem> rotationSystem) const {
+  GameState gameState{m_width, m_height, std::move(rotationSystem)};
+  applyTo(gameState);
+  return gameState;
+}
+
+uint64_t GameStateSnapshot::getHash() const {
+  uint64_t hash{m_boardKey};
+  hash ^= getQueueKey(0, static_cast<PieceType>(m_pieceType));
+  for (size_t slot{1}; const PieceType type : m_queue) {
+    hash ^= getQueueKey(slot++, type);
+  }
+  hash ^= getHoldKey(getHeldPiece());
+  if (isHoldUsed()) {
+    hash ^= zobristHoldUsedKey;
+  }
+  hash ^= getComboKey(m_combo);
+  if (isBackToBack()) {
+    hash ^= zobristBackToBackKey;
+  }
+  return hash;
+}
+
+PieceState GameStateSnapshot::getCurrentPiece() const {
+  return PieceState{static_cast<PieceType>(m_pieceType),
+                    Position{m_pieceX, m_pieceY},
+                    static_cast<Rotation>(m_pieceRotation)};
+}
+
+std::optional<PieceType> GameStateSnapshot::getHeldPiece() const {
+  if (m_heldPiece == noPiece) {
+    return std::nullopt;
+  }
+  return static_cast<PieceType>(m_heldPiece);
+}
+
+void GameStateSnapshot::setBackToBack(const bool backToBack) {
+  m_flags = static_cast<uint8_t>(backToBack ? m_flags | backToBackFlag
+                                            : m_flags & ~backToBackFlag);
+}
+
+} // namespace tetris
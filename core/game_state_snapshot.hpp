@@ -0,0 +1,175 @@
+#pragma once
+
+#include "game_state.hpp"
+#include "piece_queue.hpp"
+#include "tetris_board.hpp"
+#include "tetris_piece.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+namespace tetris {
+
+/**
+ * @class GameStateSnapshot
+ * @brief Compact, trivially copyable copy of a game state
+ *
+ * Holds what a search node needs to resume play: the board rows, the current
+ * piece, hold, the preview, the combo and back-to-back state. Rows are stored
+ * as 16-bit words, which covers boards up to 16 columns, and the preview is
+ * the inline PieceQueue, so a snapshot of a 10x40 game fits in 128 bytes and
+ * can be copied with memcpy. The rotation system is not stored; it is given
+ * back when the snapshot is applied. Neither are the score, the last
+ * placement and incoming garbage, which applying a snapshot leaves as they
+ * are.
+ */
+class GameStateSnapshot {
+public:
+  /**
+   * @brief Widest board a snapshot can hold
+   */
+  static constexpr int32_t maxSnapshotWidth{16};
+
+  /**
+   * @brief Construct an empty snapshot
+   */
+  GameStateSnapshot() = default;
+
+  /**
+   * @brief Take a snapshot of a game state
+   *
+   * @param gameState The state
+   * @return The snapshot
+   * @throws std::invalid_argument if the board is wider than maxSnapshotWidth
+   */
+  [[nodiscard]] static GameStateSnapshot
+  fromGameState(const GameState& gameState);
+
+  /**
+   * @brief Overwrite a game state with the snapshot
+   *
+   * The rotation system, score, last placement and garbage of the state are
+   * kept.
+   *
+   * @param gameState The state, with the board size of the snapshot
+   * @throws std::invalid_argument if the board sizes differ
+   */
+  void applyTo(GameState& gameState) const;
+
+  /**
+   * @brief Build a game state from the snapshot
+   *
+   * @param rotationSystem The rotation system of the state
+   * @return The state
+   */
+  [[nodiscard]] GameState
+  toGameState(std::shared_ptr<RotationSystem> rotationSystem) const;
+
+  /**
+   * @brief Get the Zobrist hash of the state, equal to GameState::getHash()
+   */
+  [[nodiscard]] uint64_t getHash() const;
+
+  /**
+   * @brief Get the Zobrist key of the board
+   */
+  [[nodiscard]] uint64_t getBoardKey() const { return m_boardKey; }
+
+  /**
+   * @brief Get the row word of a row, 0 outside the board
+   */
+  [[nodiscard]] uint32_t getRow(const int32_t row) const {
+    return row >= 0 && row < m_height ? m_rows.at(row) : 0;
+  }
+
+  /**
+   * @brief Get the state of the current piece
+   */
+  [[nodiscard]] PieceState getCurrentPiece() const;
+
+  /**
+   * @brief Get the held piece type
+   */
+  [[nodiscard]] std::optional<PieceType> getHeldPiece() const;
+
+  /**
+   * @brief Get the upcoming pieces
+   */
+  [[nodiscard]] const PieceQueue& getNextPieces() const { return m_queue; }
+
+  /**
+   * @brief Get the number of consecutive clearing placements
+   */
+  [[nodiscard]] int32_t getCombo() const { return m_combo; }
+
+  /**
+   * @brief Set the number of consecutive clearing placements
+   */
+  void setCombo(const int32_t combo) { m_combo = static_cast<int16_t>(combo); }
+
+  /**
+   * @brief Check whether a back-to-back chain is active
+   */
+  [[nodiscard]] bool isBackToBack() const {
+    return (m_flags & backToBackFlag) != 0;
+  }
+
+  /**
+   * @brief Set whether a back-to-back chain is active
+   */
+  void setBackToBack(bool backToBack);
+
+  /**
+   * @brief Check if hold has been used in the current turn
+   */
+  [[nodiscard]] bool isHoldUsed() const { return (m_flags & holdUsedFlag) != 0; }
+
+  /**
+   * @brief Check if the game is over
+   */
+  [[nodiscard]] bool isGameOver() const { return (m_flags & gameOverFlag) != 0; }
+
+  /**
+   * @brief Get the number of lines cleared
+   */
+  [[nodiscard]] int32_t getLinesCleared() const { return m_linesCleared; }
+
+  /**
+   * @brief Get the width of the board
+   */
+  [[nodiscard]] int32_t getWidth() const { return m_width; }
+
+  /**
+   * @brief Get the height of the board
+   */
+  [[nodiscard]] int32_t getHeight() const { return m_height; }
+
+  bool operator==(const GameStateSnapshot& other) const = default;
+
+private:
+  static constexpr uint8_t holdUsedFlag{1U << 0U};   ///< Hold used this turn
+  static constexpr uint8_t backToBackFlag{1U << 1U}; ///< Back-to-back active
+  static constexpr uint8_t gameOverFlag{1U << 2U};   ///< Game over
+  static constexpr uint8_t noPiece{0x7U};            ///< Empty hold code
+
+  uint64_t m_boardKey{0};                      ///< Zobrist key of the board
+  std::array<uint16_t, maxHeight> m_rows{};    ///< Row words, bottom first
+  PieceQueue m_queue;                          ///< Upcoming pieces
+  int32_t m_linesCleared{0};                   ///< Total lines cleared
+  int16_t m_combo{0};                          ///< Consecutive clears
+  int8_t m_pieceX{0};                          ///< Current piece column
+  int8_t m_pieceY{0};                          ///< Current piece row
+  uint8_t m_pieceType{0};                      ///< Current piece type
+  uint8_t m_pieceRotation{0};                  ///< Current piece rotation
+  uint8_t m_heldPiece{noPiece};                ///< Held piece type
+  uint8_t m_flags{0};                          ///< Hold, back-to-back, end
+  uint8_t m_width{0};                          ///< Width of the board
+  uint8_t m_height{0};                         ///< Height of the board
+};
+
+static_assert(std::is_trivially_copyable_v<GameStateSnapshot>);
+static_assert(sizeof(GameStateSnapshot) <= 128);
+
+} // namespace tetris
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace tetris {
+
+/**
+ * @brief Garbage rows sent by one attack
+ */
+struct GarbageBatch {
+  int32_t lines{0};      ///< Number of garbage rows
+  int32_t holeColumn{0}; ///< Empty column of the rows
+
+  bool operator==(const GarbageBatch& other) const = default;
+};
+
+/**
+ * @class GarbageQueue
+ * @brief Fixed-capacity queue of incoming garbage, oldest first
+ *
+ * Outgoing attack cancels the oldest garbage first, and garbage is inserted
+ * in arrival order. Batches live in an inline ring buffer, so the queue is
+ * trivially copyable and never allocates.
+ */
+class GarbageQueue {
+public:
+  /**
+   * @brief Maximum number of queued batches
+   */
+  static constexpr size_t capacity{16};
+
+  /**
+   * @brief Get the number of queued batches
+   */
+  [[nodiscard]] size_t size() const { return m_size; }
+
+  /**
+   * @brief Check whether the queue is empty
+   */
+  [[nodiscard]] bool empty() const { return m_size == 0; }
+
+  /**
+   * @brief Get the total number of queued garbage rows
+   */
+  [[nodiscard]] int32_t getTotalLines() const { return m_totalLines; }
+
+  /**
+   * @brief Get a batch
+   *
+   * @param index Number of batches ahead of it, 0 for the oldest
+   * @throws std::out_of_range if index is not less than size()
+   */
+  [[nodiscard]] const GarbageBatch& at(const size_t index) const {
+    [[unlikely]] if (index >= m_size) {
+      throw std::out_of_range("Garbage queue index out of range");
+    }
+    return m_batches[(m_head + index) % capacity];
+  }
+
+  /**
+   * @brief Queue incoming garbage; batches without rows are ignored
+   *
+   * @throws std::length_error if the queue is full
+   */
+  void push(const GarbageBatch& batch) {
+    if (batch.lines <= 0) {
+      return;
+    }
+    [[unlikely]] if (m_size == capacity) {
+      throw std::length_error("Garbage queue is full");
+    }
+    m_batches[(m_head + m_size) % capacity] = batch;
+    ++m_size;
+    m_totalLines += batch.lines;
+  }
+
+  /**
+   * @brief Cancel queued garbage with outgoing attack, oldest first
+   *
+   * @param attack The attack of a placement
+   * @return The attack left after cancelling, to be sent to the opponent
+   */
+  int32_t cancel(int32_t attack) {
+    while (attack > 0 && m_size > 0) {
+      GarbageBatch& oldest{m_batches[m_head]};
+      const int32_t cancelled{std::min(attack, oldest.lines)};
+      oldest.lines -= cancelled;
+      m_totalLines -= cancelled;
+      attack -= cancelled;
+      if (oldest.lines == 0) {
+        popFront();
+      }
+    }
+    return attack;
+  }
+
+  /**
+   * @brief Take rows from the oldest batch
+   *
+   * @param maxLines The most rows to take
+   * @return The rows taken and their hole column; no rows if the queue is
+   * empty
+   */
+  GarbageBatch take(const int32_t maxLines) {
+    if (m_size == 0 || maxLines <= 0) {
+      return GarbageBatch{};
+    }
+    GarbageBatch& oldest{m_batches[m_head]};
+    const GarbageBatch taken{.lines = std::min(maxLines, oldest.lines),
+                             .holeColumn = oldest.holeColumn};
+    oldest.lines -= taken.lines;
+    m_totalLines -= taken.lines;
+    if (oldest.lines == 0) {
+      popFront();
+    }
+    return taken;
+  }
+
+  /**
+   * @brief Remove every batch
+   */
+  void clear() {
+    m_head = 0;
+    m_size = 0;
+    m_totalLines = 0;
+  }
+
+private:
+  /**
+   * @brief Remove the oldest batch
+   */
+  void popFront() {
+    m_head = static_cast<uint8_t>((m_head + 1) % capacity);
+    --m_size;
+  }
+
+  std::array<GarbageBatch, capacity> m_batches{}; ///< Ring buffer of batches
+  int32_t m_totalLines{0};                        ///< Queued rows
+  uint8_t m_head{0};                              ///< Slot of the oldest batch
+  uint8_t m_size{0};                              ///< Number of batches
+};
+
+} // namespace tetris
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "tetris_piece.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace tetris {
+
+/**
+ * @class PieceQueue
+ * @brief Fixed-capacity ring buffer of upcoming pieces
+ *
+ * Pieces are stored as 3-bit codes, 21 to a 64-bit word so no code straddles
+ * two words. The buffer lives inline, so the queue is trivially copyable and
+ * pushing, popping and peeking never allocate.
+ */
+class PieceQueue {
+public:
+  /**
+   * @brief Number of piece codes stored in one word
+   */
+  static constexpr size_t codesPerWord{21};
+
+  /**
+   * @brief Number of words of the buffer
+   */
+  static constexpr size_t wordCount{2};
+
+  /**
+   * @brief Maximum number of queued pieces
+   */
+  static constexpr size_t capacity{codesPerWord * wordCount};
+
+  /**
+   * @brief Read-only iterator over the queue, front first
+   */
+  class Iterator {
+  public:
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = PieceType;
+    using difference_type = std::ptrdiff_t;
+    using reference = PieceType;
+
+    Iterator() = default;
+
+    /**
+     * @brief Construct an iterator at an index of a queue
+     */
+    Iterator(const PieceQueue* queue, const size_t index)
+        : m_queue{queue}, m_index{index} {}
+
+    PieceType operator*() const { return (*m_queue)[m_index]; }
+
+    Iterator& operator++() {
+      ++m_index;
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator previous{*this};
+      ++m_index;
+      return previous;
+    }
+
+    bool operator==(const Iterator& other) const {
+      return m_index == other.m_index;
+    }
+
+  private:
+    const PieceQueue* m_queue{nullptr}; ///< The queue iterated over
+    size_t m_index{0};                  ///< Index from the front
+  };
+
+  /**
+   * @brief Construct an empty queue
+   */
+  PieceQueue() = default;
+
+  /**
+   * @brief Construct a queue holding pieces, front first
+   *
+   * @throws std::length_error if there are more than capacity pieces
+   */
+  PieceQueue(const std::initializer_list<PieceType> pieces) {
+    for (const PieceType type : pieces) {
+      push_back(type);
+    }
+  }
+
+  /**
+   * @brief Get the number of queued pieces
+   */
+  [[nodiscard]] size_t size() const { return m_size; }
+
+  /**
+   * @brief Check whether the queue is empty
+   */
+  [[nodiscard]] bool empty() const { return m_size == 0; }
+
+  /**
+   * @brief Check whether the queue is full
+   */
+  [[nodiscard]] bool full() const { return m_size == capacity; }
+
+  /**
+   * @brief Peek a piece without bounds checking
+   *
+   * @param index Number of pieces ahead of it, 0 for the front
+   */
+  [[nodiscard]] PieceType operator[](const size_t index) const {
+    const size_t slot{(m_head + index) % capacity};
+    const auto shift{static_cast<uint32_t>((slot % codesPerWord) * 3)};
+    return static_cast<PieceType>((m_words[slot / codesPerWord] >> shift) &
+                                  0x7U);
+  }
+
+  /**
+   * @brief Peek a piece
+   *
+   * @param index Number of pieces ahead of it, 0 for the front
+   * @throws std::out_of_range if index is not less than size()
+   */
+  [[nodiscard]] PieceType at(const size_t index) const {
+    [[unlikely]] if (index >= m_size) {
+      throw std::out_of_range("Piece queue index out of range");
+    }
+    return (*this)[index];
+  }
+
+  /**
+   * @brief Get the front piece, the queue must not be empty
+   */
+  [[nodiscard]] PieceType front() const { return (*this)[0]; }
+
+  /**
+   * @brief Get the back piece, the queue must not be empty
+   */
+  [[nodiscard]] PieceType back() const { return (*this)[m_size - 1]; }
+
+  /**
+   * @brief Append a piece
+   *
+   * @throws std::length_error if the queue is full
+   */
+  void push_back(const PieceType type) {
+    [[unlikely]] if (full()) {
+      throw std::length_error("Piece queue is full");
+    }
+    const size_t slot{(m_head + m_size) % capacity};
+    const auto shift{static_cast<uint32_t>((slot % codesPerWord) * 3)};
+    uint64_t& word{m_words[slot / codesPerWord]};
+    word = (word & ~(uint64_t{0x7U} << shift)) |
+           (static_cast<uint64_t>(std::to_underlying(type)) << shift);
+    ++m_size;
+  }
+
+  /**
+   * @brief Remove the front piece, the queue must not be empty
+   */
+  void pop_front() {
+    m_head = static_cast<uint8_t>((m_head + 1) % capacity);
+    --m_size;
+  }
+
+  /**
+   * @brief Remove every piece
+   */
+  void clear() {
+    m_head = 0;
+    m_size = 0;
+  }
+
+  [[nodiscard]] Iterator begin() const { return Iterator{this, 0}; }
+  [[nodiscard]] Iterator end() const { return Iterator{this, m_size}; }
+
+  /**
+   * @brief Compare the queued pieces
+   */
+  bool operator==(const PieceQueue& other) const {
+    if (m_size != other.m_size) {
+      return false;
+    }
+    for (size_t i{0}; i < m_size; ++i) {
+      if ((*this)[i] != other[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  std::array<uint64_t, wordCount> m_words{}; ///< Packed 3-bit piece codes
+  uint8_t m_head{0};                         ///< Slot of the front piece
+  uint8_t m_size{0};                         ///< Number of queued pieces
+};
+
+} // namespace tetris
@@ -0,0 +1,72 @@
+#include "placement.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace tetris {
+
+PieceRowMasks getPieceRowMasks(const Piece& piece) {
+  PieceRowMasks masks{};
+  const auto& shape{piece.getShapeData()};
+  const int32_t xPos{piece.getState().getPosition().xPos};
+
+  for (size_t y{0}; y < Piece::maxSize; ++y) {
+    // Shape bits are stored row-major with bit (y * maxSize + x)
+    const auto rowBits{static_cast<uint32_t>(
+        (shape >> (y * Piece::maxSize)).to_ulong() & 0xFU)};
+    masks.at(y) = xPos >= 0 ? rowBits << xPos : rowBits >> -xPos;
+  }
+
+  return masks;
+}
+
+int32_t countClearedLines(const Board& board, const Piece& piece) {
+  const int32_t yPos{piece.getState().getPosition().yPos};
+  const uint32_t fullRowMask{board.getFullRowMask()};
+  const PieceRowMasks masks{getPieceRowMasks(piece)};
+
+  int32_t lines{0};
+  for (int32_t index{0}; index < static_cast<int32_t>(masks.size()); ++index) {
+    const uint32_t mask{masks.at(index)};
+    lines += static_cast<int32_t>(
+        mask != 0 && (board.getRow(yPos + index) | mask) == fullRowMask);
+  }
+
+  return lines;
+}
+
+PlacementResult placePiece(Board& board, const Piece& piece,
+                           const int32_t tSpinType) {
+  PlacementResult result{};
+  result.tSpinType = tSpinType;
+
+  const int32_t yPos{piece.getState().getPosition().yPos};
+  uint32_t columns{0};
+
+  const PieceRowMasks masks{getPieceRowMasks(piece)};
+  for (int32_t index{0}; index < static_cast<int32_t>(masks.size()); ++index) {
+    const uint32_t mask{masks.at(index)};
+    if (mask == 0) {
+      continue;
+    }
+    const int32_t row{yPos + index};
+    if (result.highestRow < result.lowestRow) {
+      result.lowestRow = row;
+    }
+    result.highestRow = row;
+    columns |= mask;
+    board.fillRowCells(row, mask);
+  }
+
+  if (columns != 0) {
+    result.leftColumn = std::countr_zero(columns);
+    result.rightColumn = 31 - std::countl_zero(columns);
+  }
+
+  result.linesCleared = board.clearFilledRows();
+  result.perfectClear =
+      result.linesCleared > 0 && board.getFilledCellCount() == 0;
+  return result;
+}
+
+} // namespace tetris
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "tetris_board.hpp"
+#include "tetris_piece.hpp"
+#include <array>
+#include <cstdint>
+
+namespace tetris {
+
+/**
+ * @brief Summary of locking a piece into a board
+ *
+ * Row and column bounds describe the cells written by the piece, in board
+ * coordinates before any line clear. Evaluators use them to update only the
+ * touched part of their cached board features.
+ */
+struct PlacementResult {
+  int32_t linesCleared{0}; ///< Number of rows cleared by the placement
+  int32_t tSpinType{0};    ///< T-spin type (0=None, 1=T-Spin, 2=T-Spin Mini)
+  int32_t lowestRow{0};    ///< Lowest row written by the piece
+  int32_t highestRow{-1};  ///< Highest row written by the piece
+  int32_t leftColumn{0};   ///< Leftmost column written by the piece
+  int32_t rightColumn{-1}; ///< Rightmost column written by the piece
+  bool perfectClear{false}; ///< Whether the placement emptied the board
+};
+
+/**
+ * @brief Row masks of a piece in board coordinates
+ *
+ * Entry i is the row word of the piece cells in board row
+ * (piece y position + i). Cells left of column 0 are dropped.
+ */
+using PieceRowMasks = std::array<uint32_t, Piece::maxSize>;
+
+/**
+ * @brief Compute the board row masks of a piece at its current position
+ *
+ * @param piece The piece
+ * @return The row masks of the piece, bottom row of its shape box first
+ */
+[[nodiscard]] PieceRowMasks getPieceRowMasks(const Piece& piece);
+
+/**
+ * @brief Count the rows a piece would complete without modifying the board
+ *
+ * @param board The board
+ * @param piece The piece at its landing position
+ * @return The number of rows that would be cleared
+ */
+[[nodiscard]] int32_t countClearedLines(const Board& board, const Piece& piece);
+
+/**
+ * @brief Lock a piece into a board and clear the completed rows
+ *
+ * The piece is written row by row, so the cost is independent of the board
+ * size apart from the line clear itself.
+ *
+ * @param board The board to modify
+ * @param piece The piece to lock
+ * @param tSpinType T-spin type of the placement, recorded in the result
+ * @return The placement result
+ */
+PlacementResult placePiece(Board& board, const Piece& piece,
+                           int32_t tSpinType = 0);
+
+} // namespace tetris
@@ -1,6 +1,8 @@
 #include "tetris_board.hpp"
+#include "zobrist.hpp"
 
 #include <algorithm>
+#include <bit>
 #include <stdexcept>
 
 namespace tetris {
@@ -14,8 +16,11 @@ Board::Board(const int32_t width, const int32_t height)
     throw std::invalid_argument("Invalid board dimensions");
   }
 
+  // A shift by the full word width is undefined, so handle 32 explicitly
+  m_fullRowMask = width == 32 ? ~uint32_t{0} : (uint32_t{1} << width) - 1;
+
   // Clear all data
-  m_cells.reset();
+  std::ranges::fill(m_rows, 0);
   std::ranges::fill(m_columnHeights, 0);
 }
 
@@ -24,17 +29,8 @@ bool Board::operator==(const Board& other) const {
     return false;
   }
 
-  // Compare only the active part of the board by checking row by row
-  for (int32_t y{0}; y < m_height; ++y) {
-    // Compare only the cells within the width of the board
-    for (int32_t x{0}; x < m_width; ++x) {
-      if (isFilled(x, y) != other.isFilled(x, y)) {
-        return false;
-      }
-    }
-  }
-
-  return true;
+  // Cells outside the board are never set, so whole rows can be compared
+  return std::ranges::equal(getRows(), other.getRows());
 }
 
 bool Board::operator!=(const Board& other) const { return !(*this == other); }
@@ -44,31 +40,13 @@ bool Board::isFilled(const int32_t x, const int32_t y) const {
     return false;
   }
 
-  return m_cells.test(y * m_width + x);
+  return ((m_rows.at(y) >> x) & 1U) != 0;
 }
 
 void Board::fillCell(const int32_t x, const int32_t y) {
   [[unlikely]] if (x < 0 || x >= m_width || y < 0 || y >= m_height) { return; }
 
-  // Calculate the bit position in the bitset
-  const size_t bitPos{static_cast<size_t>(y * maxWidth + x)};
-
-  // If the cell is already filled, do nothing
-  if (isFilled(x, y)) {
-    return;
-  }
-
-  // Set the bit for this cell
-  m_cells.set(bitPos);
-
-  // Update column height if needed
-  if (y + 1 > m_columnHeights.at(x)) {
-    m_columnHeights.at(x) = y + 1;
-    m_roof = std::max(m_roof, y + 1);
-  }
-
-  // Increment filled cell count
-  ++m_filledCellCount;
+  fillRowCells(y, uint32_t{1} << x);
 }
 
 void Board::clearCell(const int32_t x, const int32_t y) {
@@ -80,28 +58,37 @@ void Board::clearCell(const int32_t x, const int32_t y) {
   }
 
   // Clear the bit for this cell
-  m_cells.reset(y * m_width + x);
+  m_rows.at(y) &= ~(uint32_t{1} << x);
+  m_zobristKey ^= getCellKey(x, y);
 
   // Decrement filled cell count
   --m_filledCellCount;
 
   // Update column height if needed
   if (y + 1 == m_columnHeights.at(x)) {
-    // Find the new height for this column
-    int32_t newHeight{0};
-    for (int32_t i{y - 1}; i >= 0; --i) {
-      if (isFilled(x, i)) {
-        newHeight = i + 1;
-        break;
-      }
-    }
-    m_columnHeights.at(x) = newHeight;
+    updateHeights(x);
+  }
+}
 
-    // Recalculate roof if needed
-    if (y + 1 == m_roof) {
-      updateHeights();
-    }
+void Board::fillRowCells(const int32_t row, uint32_t mask) {
+  [[unlikely]] if (row < 0 || row >= m_height) { return; }
+
+  // Only keep cells that are inside the board and not filled yet
+  mask &= m_fullRowMask & ~m_rows.at(row);
+  if (mask == 0) {
+    return;
   }
+
+  m_rows.at(row) |= mask;
+  m_filledCellCount += std::popcount(mask);
+
+  // Raise the height of every column that received a cell
+  for (uint32_t bits{mask}; bits != 0; bits &= bits - 1) {
+    const int32_t column{std::countr_zero(bits)};
+    m_columnHeights.at(column) = std::max(m_columnHeights.at(column), row + 1);
+    m_zobristKey ^= getCellKey(column, row);
+  }
+  m_roof = std::max(m_roof, row + 1);
 }
 
 int32_t Board::getColumnHeight(const int32_t column) const {
@@ -113,58 +100,90 @@ int32_t Board::getColumnHeight(const int32_t column) const {
 int32_t Board::clearFilledRows() {
   int32_t rowsCleared{0};
 
-  // Check each row from bottom to top
-  for (int32_t y{0}; y < m_height; ++y) {
-    if (isRowFilled(y)) {
-      // This row is full, shift rows down by copying entire rows at once
-      for (int32_t i{y}; i < m_height - 1; ++i) {
-        // Copy the entire row at once using a loop over just the width
-        for (int32_t x{0}; x < m_width; ++x) {
-          if (isFilled(x, i + 1)) {
-            fillCell(x, i);
-          } else {
-            clearCell(x, i);
-          }
-        }
-      }
-
-      // Clear the top row
-      for (int32_t x{0}; x < m_width; ++x) {
-        clearCell(x, m_height - 1);
-      }
-
-      // Update counters
+  // Compact the non-full rows downwards, one word per row
+  int32_t writeRow{0};
+  for (int32_t y{0}; y < m_roof; ++y) {
+    if (m_rows.at(y) == m_fullRowMask) {
       ++rowsCleared;
-      m_filledCellCount -= m_width;
-
-      // Stay on the same row index since we shifted everything down
-      --y;
+      continue;
     }
+    m_rows.at(writeRow++) = m_rows.at(y);
   }
 
-  // If we cleared any rows, update heights
+  // If we cleared any rows, empty the vacated top rows and update heights
   if (rowsCleared > 0) {
+    std::fill(m_rows.begin() + writeRow, m_rows.begin() + m_roof, 0U);
+    m_filledCellCount -= rowsCleared * m_width;
     updateHeights();
+    updateZobristKey();
   }
 
   return rowsCleared;
 }
 
-bool Board::isRowFilled(const int32_t row) const {
-  [[unlikely]] if (row < 0 || row >= m_height) { return false; }
+bool Board::insertGarbage(const int32_t rows, const int32_t holeColumn) {
+  [[unlikely]] if (rows < 0 || holeColumn < 0 || holeColumn >= m_width) {
+    throw std::invalid_argument("Invalid garbage rows or hole column");
+  }
+  if (rows == 0) {
+    return true;
+  }
 
-  // Check each cell in the row directly
-  for (int32_t x{0}; x < m_width; ++x) {
-    if (!isFilled(x, row)) {
-      return false;
+  // Cells of the rows pushed past the top are lost
+  const int32_t shift{std::min(rows, m_height)};
+  int32_t lostCells{0};
+  for (int32_t y{m_height - shift}; y < m_roof; ++y) {
+    lostCells += std::popcount(m_rows.at(y));
+  }
+
+  // Move the kept rows up, top first, one word per row
+  for (int32_t y{std::min(m_roof, m_height - shift) - 1}; y >= 0; --y) {
+    m_rows.at(y + shift) = m_rows.at(y);
+  }
+  const uint32_t garbageRow{m_fullRowMask & ~(uint32_t{1} << holeColumn)};
+  std::fill(m_rows.begin(), m_rows.begin() + shift, garbageRow);
+  m_filledCellCount += shift * (m_width - 1) - lostCells;
+
+  if (lostCells == 0) {
+    // Every column rises by the garbage, empty ones only where it is filled
+    for (int32_t column{0}; column < m_width; ++column) {
+      int32_t& height{m_columnHeights.at(column)};
+      height = height > 0 || column != holeColumn ? height + shift : 0;
     }
+    m_roof += shift;
+  } else {
+    updateHeights();
   }
+  updateZobristKey();
+
+  return lostCells == 0 && rows <= m_height;
+}
+
+bool Board::isRowFilled(const int32_t row) const {
+  [[unlikely]] if (row < 0 || row >= m_height) { return false; }
+
+  return m_rows.at(row) == m_fullRowMask;
+}
+
+uint32_t Board::getRow(const int32_t row) const {
+  [[unlikely]] if (row < 0 || row >= m_height) { return 0; }
 
-  return true;
+  return m_rows.at(row);
 }
 
-const std::bitset<maxWidth * maxHeight>& Board::getCells() const {
-  return m_cells;
+std::span<const uint32_t> Board::getRows() const {
+  return {m_rows.data(),
+          static_cast<std::span<const uint32_t>::size_type>(m_height)};
+}
+
+std::bitset<maxWidth * maxHeight> Board::getCells() const {
+  std::bitset<maxWidth * maxHeight> cells{};
+  for (int32_t y{0}; y < m_roof; ++y) {
+    for (uint32_t bits{m_rows.at(y)}; bits != 0; bits &= bits - 1) {
+      cells.set(static_cast<size_t>(y * maxWidth + std::countr_zero(bits)));
+    }
+  }
+  return cells;
 }
 
 std::span<const int32_t> Board::getColumnHeights() const {
@@ -173,18 +192,23 @@ std::span<const int32_t> Board::getColumnHeights() const {
 }
 
 void Board::updateHeights() {
+  std::ranges::fill(m_columnHeights, 0);
   m_roof = 0;
 
-  // Recalculate all column heights
-  for (int32_t x{0}; x < m_width; ++x) {
-    m_columnHeights.at(x) = 0;
-    for (int32_t y{m_height - 1}; y >= 0; --y) {
-      if (isFilled(x, y)) {
-        m_columnHeights.at(x) = y + 1;
-        m_roof = std::max(m_roof, y + 1);
-        break;
-      }
+  // Walk down from the top; the first row that covers a column sets its height
+  uint32_t unseen{m_fullRowMask};
+  for (int32_t y{m_height - 1}; y >= 0 && unseen != 0; --y) {
+    const uint32_t covered{m_rows.at(y) & unseen};
+    if (covered == 0) {
+      continue;
     }
+    if (m_roof == 0) {
+      m_roof = y + 1;
+    }
+    for (uint32_t bits{covered}; bits != 0; bits &= bits - 1) {
+      m_columnHeights.at(std::countr_zero(bits)) = y + 1;
+    }
+    unseen &= ~covered;
   }
 }
 
@@ -193,8 +217,8 @@ void Board::updateHeights(const int32_t column) {
 
   // Recalculate the height just for this column
   m_columnHeights.at(column) = 0;
-  for (int32_t y{m_height - 1}; y >= 0; --y) {
-    if (isFilled(column, y)) {
+  for (int32_t y{m_roof - 1}; y >= 0; --y) {
+    if (((m_rows.at(y) >> column) & 1U) != 0) {
       m_columnHeights.at(column) = y + 1;
       break;
     }
@@ -207,4 +231,13 @@ void Board::updateHeights(const int32_t column) {
   }
 }
 
-} // namespace tetris
\ No newline at end of file
+void Board::updateZobristKey() {
+  m_zobristKey = 0;
+  for (int32_t y{0}; y < m_roof; ++y) {
+    for (uint32_t bits{m_rows.at(y)}; bits != 0; bits &= bits - 1) {
+      m_zobristKey ^= getCellKey(std::countr_zero(bits), y);
+    }
+  }
+}
+
+} // namespace tetris
@@ -23,6 +23,8 @@ constexpr int32_t maxWidth{32};
  *
  * (0,0) is the bottom-left corner.
  * The board supports a maximum size of maxHeight * maxWidth.
+ * Each row is stored as a 32-bit word with bit x representing column x, so
+ * row-wide operations such as line clears work on whole words.
  */
 class Board {
 public:
@@ -97,6 +99,16 @@ public:
    */
   [[nodiscard]] int32_t getFilledCellCount() const { return m_filledCellCount; }
 
+  /**
+   * @brief Get the Zobrist key of the board
+   *
+   * The key is the XOR of the keys of all filled cells and is maintained as
+   * cells are filled, cleared or shifted.
+   *
+   * @return The Zobrist key, 0 for an empty board
+   */
+  [[nodiscard]] uint64_t getZobristKey() const { return m_zobristKey; }
+
   /**
    * @brief Get the height of the highest filled cell in a column
    *
@@ -112,6 +124,20 @@ public:
    */
   int32_t clearFilledRows();
 
+  /**
+   * @brief Push garbage rows up from the bottom
+   *
+   * The existing rows move up by whole words and the new bottom rows are
+   * filled except for one column. Cells pushed past the top are lost.
+   *
+   * @param rows The number of garbage rows
+   * @param holeColumn The empty column of the garbage rows
+   * @return false if filled cells or garbage rows did not fit in the board
+   * @throws std::invalid_argument if rows is negative or holeColumn is
+   * outside the board
+   */
+  bool insertGarbage(int32_t rows, int32_t holeColumn);
+
   /**
    * @brief Check if a row is filled
    *
@@ -121,11 +147,48 @@ public:
   [[nodiscard]] bool isRowFilled(int32_t row) const;
 
   /**
-   * @brief Get a read-only reference to the board cells
+   * @brief Fill every cell of a row selected by a column mask
+   *
+   * Bit x of the mask selects column x. Cells outside the board width are
+   * ignored.
+   *
+   * @param row The row index
+   * @param mask The column mask of the cells to fill
+   */
+  void fillRowCells(int32_t row, uint32_t mask);
+
+  /**
+   * @brief Get the row word of a row
+   *
+   * Bit x of the word is set when the cell in column x is filled.
+   *
+   * @param row The row index
+   * @return The row word, 0 for rows outside the board
+   */
+  [[nodiscard]] uint32_t getRow(int32_t row) const;
+
+  /**
+   * @brief Get a read-only view of all row words, bottom row first
+   *
+   * @return A span of the row words
+   */
+  [[nodiscard]] std::span<const uint32_t> getRows() const;
+
+  /**
+   * @brief Get the row word of a completely filled row
    *
-   * @return A reference to the bitset representing the board
+   * @return The mask with one bit set per board column
    */
-  [[nodiscard]] const std::bitset<maxWidth * maxHeight>& getCells() const;
+  [[nodiscard]] uint32_t getFullRowMask() const { return m_fullRowMask; }
+
+  /**
+   * @brief Get a copy of the board cells as a bitset
+   *
+   * Bit (y * maxWidth + x) is set when the cell (x, y) is filled.
+   *
+   * @return The bitset representing the board
+   */
+  [[nodiscard]] std::bitset<maxWidth * maxHeight> getCells() const;
 
   /**
    * @brief Get a read-only view of the column heights
@@ -147,13 +210,19 @@ private:
    */
   void updateHeights(int32_t column);
 
-  std::bitset<maxWidth * maxHeight>
-      m_cells{}; ///< Bit representation of the board
+  /**
+   * @brief Recompute the Zobrist key from the filled cells
+   */
+  void updateZobristKey();
+
+  std::array<uint32_t, maxHeight> m_rows{}; ///< One bit per cell, per row
   std::array<int32_t, maxWidth> m_columnHeights{}; ///< Height of each column
   int32_t m_width{};                               ///< Width of the board
   int32_t m_height{};                              ///< Height of the board
+  uint32_t m_fullRowMask{};    ///< Row word of a filled row
   int32_t m_roof{};            ///< Current highest filled cell
   int32_t m_filledCellCount{}; ///< Number of filled cells
+  uint64_t m_zobristKey{};     ///< XOR of the keys of the filled cells
 };
 
 } // namespace tetris
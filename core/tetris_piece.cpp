@@ -1,6 +1,7 @@
 #include "tetris_piece.hpp"
 #include "../rotation_systems/rotation_system.hpp"
 #include <algorithm>
+#include <bit>
 #include <stdexcept>
 #include <utility>
 
@@ -38,7 +39,7 @@ std::vector<Position> Piece::getFilledCells() const {
 
   for (int32_t y{0}; y < m_height; ++y) {
     for (int32_t x{0}; x < m_width; ++x) {
-      if (m_shapeData.test(y * m_width + x)) {
+      if (m_shapeData.test(y * maxSize + x)) {
         filledCells.emplace_back(x, y);
       }
     }
@@ -70,28 +71,34 @@ void Piece::updateShapeData() {
 }
 
 void Piece::updateDimensions() {
-  // Reset dimensions
-  m_width = 0;
-  m_height = 0;
-  std::ranges::fill(m_columnHeights, 0);
-  std::ranges::fill(m_columnBottoms, maxSize);
-
-  // Find the actual dimensions of the piece
-  for (int32_t y{0}; y < static_cast<int32_t>(maxSize); ++y) {
-    bool rowHasFilledCells = false;
-
-    for (int32_t x{0}; x < static_cast<int32_t>(maxSize); ++x) {
-      if (m_shapeData.test(y * maxSize + x)) {
-        rowHasFilledCells = true;
-        m_width = std::max(m_width, x + 1);
-        m_columnHeights.at(x) = std::max(m_columnHeights.at(x), y + 1);
-        m_columnBottoms.at(x) = std::min(m_columnBottoms.at(x), y);
-      }
+  // Work on the shape as one word: ORing the rows gives the occupied
+  // columns, and masking one bit per row gives the cells of a column
+  const auto bits{static_cast<uint32_t>(m_shapeData.to_ulong())};
+  constexpr uint32_t rowMask{(1U << maxSize) - 1};
+  constexpr uint32_t columnMask{[] {
+    uint32_t mask{0};
+    for (size_t y{0}; y < maxSize; ++y) {
+      mask |= 1U << (y * maxSize);
     }
+    return mask;
+  }()};
 
-    if (rowHasFilledCells) {
-      m_height = y + 1;
-    }
+  uint32_t columns{0};
+  for (size_t y{0}; y < maxSize; ++y) {
+    columns |= (bits >> (y * maxSize)) & rowMask;
+  }
+  m_width = std::bit_width(columns);
+  m_height = (std::bit_width(bits) + static_cast<int32_t>(maxSize) - 1) /
+             static_cast<int32_t>(maxSize);
+
+  for (size_t x{0}; x < maxSize; ++x) {
+    const uint32_t column{(bits >> x) & columnMask};
+    m_columnHeights.at(x) =
+        (std::bit_width(column) + static_cast<int32_t>(maxSize) - 1) /
+        static_cast<int32_t>(maxSize);
+    m_columnBottoms.at(x) =
+        column == 0 ? static_cast<int32_t>(maxSize)
+                    : std::countr_zero(column) / static_cast<int32_t>(maxSize);
   }
 }
 
@@ -22,6 +22,11 @@ enum class PieceType {
   Z,
 };
 
+/**
+ * @brief Number of entries in PieceType
+ */
+constexpr size_t pieceTypeCount{7};
+
 /**
  * @brief Enumeration of rotation states
  */
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "tetris_board.hpp"
+#include "tetris_piece.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+
+namespace tetris {
+
+/**
+ * @brief Advance a SplitMix64 state and return the next value
+ *
+ * Used to generate the Zobrist tables at compile time, so keys are identical
+ * across builds and platforms.
+ *
+ * @param state The generator state, updated in place
+ * @return The next pseudo-random value
+ */
+constexpr uint64_t splitMix64(uint64_t& state) {
+  state += 0x9E3779B97F4A7C15ULL;
+  uint64_t value{state};
+  value = (value ^ (value >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+  value = (value ^ (value >> 27U)) * 0x94D049BB133111EBULL;
+  return value ^ (value >> 31U);
+}
+
+/**
+ * @brief Generate a table of Zobrist keys
+ *
+ * @tparam Size The number of keys
+ * @param seed The generator seed, distinct per table
+ * @return The keys
+ */
+template <size_t Size>
+constexpr std::array<uint64_t, Size> makeZobristKeys(uint64_t seed) {
+  std::array<uint64_t, Size> keys{};
+  for (auto& key : keys) {
+    key = splitMix64(seed);
+  }
+  return keys;
+}
+
+/**
+ * @brief Zobrist key of every board cell, indexed by (y * maxWidth + x)
+ */
+inline constexpr auto zobristCellKeys{
+    makeZobristKeys<static_cast<size_t>(maxWidth * maxHeight)>(
+        0x5A0B5157CE115ULL)};
+
+/**
+ * @brief Get the Zobrist key of a board cell
+ *
+ * @param x X-coordinate (column)
+ * @param y Y-coordinate (row)
+ * @return The key of the cell
+ */
+[[nodiscard]] constexpr uint64_t getCellKey(const int32_t x, const int32_t y) {
+  return zobristCellKeys[static_cast<size_t>(y * maxWidth + x)];
+}
+
+/**
+ * @brief Number of queue slots with keys, later pieces are not hashed
+ *
+ * Slot 0 is the current piece, the following slots are the preview.
+ */
+inline constexpr size_t zobristQueueLength{32};
+
+/**
+ * @brief Zobrist key of every piece type in every queue slot, indexed by
+ * (slot * pieceTypeCount + type)
+ */
+inline constexpr auto zobristQueueKeys{
+    makeZobristKeys<zobristQueueLength * pieceTypeCount>(0x9E11E7C0DE5ULL)};
+
+/**
+ * @brief Zobrist key of every held piece type
+ */
+inline constexpr auto zobristHoldKeys{
+    makeZobristKeys<pieceTypeCount>(0x401DC0FFEEULL)};
+
+/**
+ * @brief Zobrist key of a used hold
+ */
+inline constexpr uint64_t zobristHoldUsedKey{
+    makeZobristKeys<1>(0x401D05EDULL)[0]};
+
+/**
+ * @brief Get the Zobrist key of a piece in a queue slot
+ *
+ * @param slot The queue slot, 0 for the current piece
+ * @param type The piece type
+ * @return The key, 0 for slots beyond zobristQueueLength
+ */
+[[nodiscard]] constexpr uint64_t getQueueKey(const size_t slot,
+                                             const PieceType type) {
+  if (slot >= zobristQueueLength) {
+    return 0;
+  }
+  return zobristQueueKeys[slot * pieceTypeCount +
+                          static_cast<size_t>(std::to_underlying(type))];
+}
+
+/**
+ * @brief Get the Zobrist key of a piece queue
+ *
+ * @param queue The current piece followed by the preview
+ * @return The XOR of the keys of every piece in its slot
+ */
+[[nodiscard]] constexpr uint64_t getQueueKey(std::span<const PieceType> queue) {
+  uint64_t key{0};
+  for (size_t slot{0}; slot < queue.size(); ++slot) {
+    key ^= getQueueKey(slot, queue[slot]);
+  }
+  return key;
+}
+
+/**
+ * @brief Get the Zobrist key of the hold slot
+ *
+ * @param held The held piece, if any
+ * @return The key, 0 for an empty hold
+ */
+[[nodiscard]] constexpr uint64_t
+getHoldKey(const std::optional<PieceType> held) {
+  if (!held.has_value()) {
+    return 0;
+  }
+  return zobristHoldKeys[static_cast<size_t>(std::to_underlying(*held))];
+}
+
+/**
+ * @brief Number of combo counts with keys, longer combos share the last key
+ */
+inline constexpr size_t zobristComboLength{32};
+
+/**
+ * @brief Zobrist key of every combo count
+ */
+inline constexpr auto zobristComboKeys{
+    makeZobristKeys<zobristComboLength>(0xC0B0C0B0ULL)};
+
+/**
+ * @brief Zobrist key of an active back-to-back chain
+ */
+inline constexpr uint64_t zobristBackToBackKey{
+    makeZobristKeys<1>(0xB2BB2BB2BULL)[0]};
+
+/**
+ * @brief Get the Zobrist key of a combo count
+ *
+ * @param combo The number of consecutive line clears
+ * @return The key, 0 without a combo
+ */
+[[nodiscard]] constexpr uint64_t getComboKey(const int32_t combo) {
+  if (combo <= 0) {
+    return 0;
+  }
+  return zobristComboKeys[std::min(static_cast<size_t>(combo),
+                                   zobristComboLength - 1)];
+}
+
+} // namespace tetris
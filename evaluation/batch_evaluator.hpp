@@ -0,0 +1,171 @@
+#pragma once
+
+#include "../core/placement.hpp"
+#include "../core/tetris_board.hpp"
+#include "board_features.hpp"
+#include "linear_evaluator.hpp"
+#include <array>
+#include <cstdint>
+#include <span>
+
+namespace tetris {
+
+/**
+ * @class BoardBatch
+ * @brief Candidate boards laid out structure-of-arrays for batch evaluation
+ *
+ * Row words and column heights of up to laneCount boards are stored lane-major
+ * (all lanes of row y are contiguous), so the feature kernels process every
+ * lane of a row in the same loop iteration and compile to vector
+ * instructions.
+ */
+class BoardBatch {
+public:
+  /**
+   * @brief Number of boards held by one batch
+   */
+  static constexpr size_t laneCount{16};
+
+  /**
+   * @brief One value per lane
+   */
+  template <typename T> using LaneArray = std::array<T, laneCount>;
+
+  /**
+   * @brief Default constructor, an empty batch
+   */
+  BoardBatch() = default;
+
+  /**
+   * @brief Remove all boards from the batch
+   */
+  void clear();
+
+  /**
+   * @brief Add a board to the next free lane
+   *
+   * All boards in a batch must have the same dimensions.
+   *
+   * @param board The board after the placement
+   * @param placement The result of the placement
+   * @return The lane index of the board
+   * @throws std::length_error if the batch is full
+   * @throws std::invalid_argument if the board width differs from the batch
+   */
+  size_t add(const Board& board, const PlacementResult& placement);
+
+  /**
+   * @brief Get the number of boards in the batch
+   */
+  [[nodiscard]] size_t size() const { return m_size; }
+
+  /**
+   * @brief Check if the batch has no free lane
+   */
+  [[nodiscard]] bool isFull() const { return m_size == laneCount; }
+
+  /**
+   * @brief Check if the batch holds no board
+   */
+  [[nodiscard]] bool isEmpty() const { return m_size == 0; }
+
+private:
+  friend class BatchEvaluator;
+
+  alignas(64) std::array<LaneArray<uint32_t>, maxHeight> m_rows{}; ///< Rows
+  alignas(64)
+      std::array<LaneArray<int32_t>, maxWidth> m_heights{}; ///< Heights
+  alignas(64) LaneArray<int32_t> m_roofs{};          ///< Highest column
+  alignas(64) LaneArray<int32_t> m_filledCells{};    ///< Filled cell count
+  alignas(64) LaneArray<int32_t> m_linesCleared{};   ///< Placement lines
+  alignas(64) LaneArray<int32_t> m_tSpinLines{};     ///< Placement T-spin lines
+  int32_t m_width{};          ///< Width shared by every board
+  int32_t m_height{};         ///< Height shared by every board
+  uint32_t m_fullRowMask{};   ///< Row word of a filled row
+  int32_t m_highestRoof{};    ///< Highest roof over all lanes
+  size_t m_size{};            ///< Number of occupied lanes
+};
+
+/**
+ * @class BatchEvaluator
+ * @brief Linear evaluator scoring a whole BoardBatch at once
+ *
+ * Uses the same feature definitions and weights as LinearEvaluator, so a board
+ * scores the same whether it is evaluated alone or in a batch.
+ */
+class BatchEvaluator {
+public:
+  /**
+   * @brief Construct with the default weights
+   */
+  BatchEvaluator();
+
+  /**
+   * @brief Construct with the given weights
+   *
+   * @param weights The feature weights
+   */
+  explicit BatchEvaluator(const LinearEvaluator::Weights& weights);
+
+  /**
+   * @brief Compute the features of every board in a batch
+   *
+   * @param batch The batch
+   * @param features Output, one feature vector per occupied lane
+   */
+  void computeFeatures(const BoardBatch& batch,
+                       std::span<FeatureVector> features) const;
+
+  /**
+   * @brief Score every board in a batch
+   *
+   * @param batch The batch
+   * @param scores Output, one score per occupied lane
+   */
+  void evaluate(const BoardBatch& batch, std::span<double> scores) const;
+
+  /**
+   * @brief Score a list of boards, batching them internally
+   *
+   * @param boards The boards after their placements
+   * @param placements The placement results, parallel to boards
+   * @param scores Output, parallel to boards
+   */
+  void evaluate(std::span<const Board> boards,
+                std::span<const PlacementResult> placements,
+                std::span<double> scores) const;
+
+  /**
+   * @brief Get the feature weights
+   */
+  [[nodiscard]] const LinearEvaluator::Weights& getWeights() const {
+    return m_weights;
+  }
+
+  /**
+   * @brief Set the feature weights
+   */
+  void setWeights(const LinearEvaluator::Weights& weights) {
+    m_weights = weights;
+  }
+
+private:
+  /**
+   * @brief Per-lane feature values, one array per feature
+   */
+  using LaneFeatures =
+      std::array<BoardBatch::LaneArray<int32_t>, featureCount>;
+
+  /**
+   * @brief Compute the per-lane feature values of a batch
+   *
+   * @param batch The batch
+   * @param features Output, feature-major
+   */
+  static void computeLaneFeatures(const BoardBatch& batch,
+                                  LaneFeatures& features);
+
+  LinearEvaluator::Weights m_weights; ///< Weight of every feature
+};
+
+} // namespace tetris
@@ -0,0 +1,91 @@
+#include "board_features.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+namespace tetris {
+
+std::string_view getFeatureName(const Feature feature) {
+  switch (feature) {
+  case Feature::AggregateHeight:
+    return "AggregateHeight";
+  case Feature::MaxHeight:
+    return "MaxHeight";
+  case Feature::Bumpiness:
+    return "Bumpiness";
+  case Feature::Holes:
+    return "Holes";
+  case Feature::RowTransitions:
+    return "RowTransitions";
+  case Feature::ColumnTransitions:
+    return "ColumnTransitions";
+  case Feature::WellCells:
+    return "WellCells";
+  case Feature::LinesCleared:
+    return "LinesCleared";
+  case Feature::TSpinLines:
+    return "TSpinLines";
+  default:
+    return "Unknown";
+  }
+}
+
+BoardFeatures::BoardFeatures(const Board& board) { compute(board); }
+
+void BoardFeatures::update(const Board& board,
+                           const PlacementResult& placement) {
+  // Line clears move every row above them, rescan the board instead
+  if (placement.linesCleared > 0 ||
+      placement.highestRow < placement.lowestRow) {
+    compute(board);
+    return;
+  }
+
+  // Row terms: the piece rows, plus the column transitions above the top one
+  const int32_t firstRow{placement.lowestRow};
+  const int32_t lastRow{std::min(placement.highestRow + 1,
+                                 board.getHeight() - 1)};
+  for (int32_t y{firstRow}; y <= lastRow; ++y) {
+    m_rowTransitionSum -= m_rowTransitions.at(y);
+    m_columnTransitionSum -= m_columnTransitions.at(y);
+    m_wellCellSum -= m_wellCells.at(y);
+  }
+  updateRows(board, firstRow, lastRow);
+  for (int32_t y{firstRow}; y <= lastRow; ++y) {
+    m_rowTransitionSum += m_rowTransitions.at(y);
+    m_columnTransitionSum += m_columnTransitions.at(y);
+    m_wellCellSum += m_wellCells.at(y);
+  }
+
+  // Column terms: the piece columns and the bumpiness pairs next to them
+  const int32_t firstPair{std::max(placement.leftColumn - 1, 0)};
+  const int32_t lastPair{std::min(placement.rightColumn, m_width - 2)};
+  for (int32_t x{firstPair}; x <= lastPair; ++x) {
+    m_bumpiness -= bumpinessAt(x);
+  }
+  for (int32_t x{placement.leftColumn}; x <= placement.rightColumn; ++x) {
+    const auto height{static_cast<int8_t>(board.getColumnHeight(x))};
+    m_aggregateHeight += height - m_heights.at(x);
+    m_heights.at(x) = height;
+  }
+  for (int32_t x{firstPair}; x <= lastPair; ++x) {
+    m_bumpiness += bumpinessAt(x);
+  }
+
+  m_maxHeight = board.getRoof();
+  m_holes = m_aggregateHeight - board.getFilledCellCount();
+}
+
+FeatureVector
+BoardFeatures::getFeatureVector(const PlacementResult& placement) const {
+  return [&]<size_t... I>(std::index_sequence<I...>) {
+    return FeatureVector{get<static_cast<Feature>(I)>(placement)...};
+  }(std::make_index_sequence<featureCount>{});
+}
+
+int32_t BoardFeatures::bumpinessAt(const int32_t column) const {
+  return std::abs(m_heights.at(column) - m_heights.at(column + 1));
+}
+
+} // namespace tetris
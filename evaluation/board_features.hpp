@@ -0,0 +1,358 @@
+#pragma once
+
+#include "../core/placement.hpp"
+#include "../core/tetris_board.hpp"
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace tetris {
+
+/**
+ * @brief Enumeration of the features used to evaluate a placement
+ *
+ * Board features describe the board after the placement, placement features
+ * describe the placement itself.
+ */
+enum class Feature {
+  AggregateHeight,   ///< Sum of all column heights
+  MaxHeight,         ///< Height of the highest column
+  Bumpiness,         ///< Sum of height differences of adjacent columns
+  Holes,             ///< Empty cells below the top of their column
+  RowTransitions,    ///< Filled/empty changes along rows, walls count filled
+  ColumnTransitions, ///< Filled/empty changes along columns, floor is filled
+  WellCells,         ///< Empty cells with both horizontal neighbours filled
+  LinesCleared,      ///< Rows cleared by the placement
+  TSpinLines,        ///< Rows cleared by a T-spin placement
+};
+
+/**
+ * @brief Number of entries in Feature
+ */
+constexpr size_t featureCount{9};
+
+/**
+ * @brief Value of every feature, indexed by Feature
+ */
+using FeatureVector = std::array<int32_t, featureCount>;
+
+/**
+ * @brief Set of features, bit i selects the feature with underlying value i
+ */
+using FeatureMask = uint32_t;
+
+/**
+ * @brief Get the mask bit of a feature
+ *
+ * @param feature The feature
+ * @return The mask with only that feature selected
+ */
+[[nodiscard]] constexpr FeatureMask featureBit(const Feature feature) {
+  return FeatureMask{1} << static_cast<uint32_t>(feature);
+}
+
+/**
+ * @brief Mask selecting every feature
+ */
+constexpr FeatureMask allFeatures{(FeatureMask{1} << featureCount) - 1};
+
+/**
+ * @brief Get the name of a feature
+ *
+ * @param feature The feature
+ * @return The feature name
+ */
+[[nodiscard]] std::string_view getFeatureName(Feature feature);
+
+/**
+ * @brief Transitions between horizontally adjacent cells of a row word
+ *
+ * Bit x is set when columns x and x + 1 differ.
+ *
+ * @param row The row word
+ * @param fullRowMask The row word of a filled row
+ * @return The transition bits inside the row
+ */
+[[nodiscard]] constexpr uint32_t rowInnerTransitionBits(
+    const uint32_t row, const uint32_t fullRowMask) {
+  return (row ^ (row >> 1U)) & (fullRowMask >> 1U);
+}
+
+/**
+ * @brief Transitions between a row word and the walls
+ *
+ * Bit 0 and the top column bit are set when the cell next to the wall is
+ * empty.
+ *
+ * @param row The row word
+ * @param fullRowMask The row word of a filled row
+ * @return The transition bits at the walls
+ */
+[[nodiscard]] constexpr uint32_t rowWallTransitionBits(
+    const uint32_t row, const uint32_t fullRowMask) {
+  return ~row & (1U | (fullRowMask ^ (fullRowMask >> 1U)));
+}
+
+/**
+ * @brief Transitions between two vertically adjacent row words
+ *
+ * @param below The row word below, fullRowMask for the floor
+ * @param row The row word above
+ * @param fullRowMask The row word of a filled row
+ * @return The bits of the columns that change between the two rows
+ */
+[[nodiscard]] constexpr uint32_t columnTransitionBits(
+    const uint32_t below, const uint32_t row, const uint32_t fullRowMask) {
+  return (below ^ row) & fullRowMask;
+}
+
+/**
+ * @brief Well cells of a row word
+ *
+ * @param row The row word
+ * @param fullRowMask The row word of a filled row
+ * @return The bits of the empty cells whose left and right neighbours are
+ * filled or walls
+ */
+[[nodiscard]] constexpr uint32_t wellCellBits(const uint32_t row,
+                                              const uint32_t fullRowMask) {
+  const uint32_t leftFilled{row << 1U | 1U};
+  const uint32_t rightFilled{row >> 1U | (fullRowMask ^ (fullRowMask >> 1U))};
+  return ~row & leftFilled & rightFilled & fullRowMask;
+}
+
+/**
+ * @brief Row transitions of one row word
+ *
+ * Empty rows contribute nothing so that the rows above the stack do not
+ * dominate the feature.
+ *
+ * @param row The row word
+ * @param fullRowMask The row word of a filled row
+ * @return The number of filled/empty changes including the walls
+ */
+[[nodiscard]] constexpr int32_t rowTransitions(const uint32_t row,
+                                               const uint32_t fullRowMask) {
+  if (row == 0) {
+    return 0;
+  }
+  return std::popcount(rowInnerTransitionBits(row, fullRowMask)) +
+         std::popcount(rowWallTransitionBits(row, fullRowMask));
+}
+
+/**
+ * @brief Column transitions between two vertically adjacent row words
+ *
+ * @param below The row word below, fullRowMask for the floor
+ * @param row The row word above
+ * @param fullRowMask The row word of a filled row
+ * @return The number of columns that change between the two rows
+ */
+[[nodiscard]] constexpr int32_t columnTransitions(const uint32_t below,
+                                                  const uint32_t row,
+                                                  const uint32_t fullRowMask) {
+  return std::popcount(columnTransitionBits(below, row, fullRowMask));
+}
+
+/**
+ * @brief Well cells of one row word
+ *
+ * @param row The row word
+ * @param fullRowMask The row word of a filled row
+ * @return The number of empty cells whose left and right neighbours are
+ * filled or walls
+ */
+[[nodiscard]] constexpr int32_t wellCells(const uint32_t row,
+                                          const uint32_t fullRowMask) {
+  return std::popcount(wellCellBits(row, fullRowMask));
+}
+
+/**
+ * @class BoardFeatures
+ * @brief Board features with the per-row and per-column terms they sum
+ *
+ * Keeping the individual terms lets a placement update the features from the
+ * rows and columns it touched instead of rescanning the whole board. Placements
+ * that clear lines shift every row above them, so those fall back to a full
+ * recomputation.
+ */
+class BoardFeatures {
+public:
+  /**
+   * @brief Default constructor, features of an empty board
+   */
+  BoardFeatures() = default;
+
+  /**
+   * @brief Construct the features of a board
+   *
+   * @param board The board
+   */
+  explicit BoardFeatures(const Board& board);
+
+  /**
+   * @brief Recompute features from a board
+   *
+   * Features outside the mask are skipped and read as 0. Incremental updates
+   * require every feature to have been computed.
+   *
+   * @tparam Enabled The features to compute
+   * @param board The board
+   */
+  template <FeatureMask Enabled = allFeatures> void compute(const Board& board);
+
+  /**
+   * @brief Update the features after a placement
+   *
+   * The features must describe the board before the placement.
+   *
+   * @param board The board after the placement
+   * @param placement The result of the placement
+   */
+  void update(const Board& board, const PlacementResult& placement);
+
+  /**
+   * @brief Get the value of a feature
+   *
+   * @tparam F The feature
+   * @param placement The placement that produced the board
+   * @return The feature value
+   */
+  template <Feature F>
+  [[nodiscard]] int32_t get(const PlacementResult& placement) const;
+
+  /**
+   * @brief Get the values of all features for a placement
+   *
+   * @param placement The placement that produced the board
+   * @return The board and placement feature values
+   */
+  [[nodiscard]] FeatureVector
+  getFeatureVector(const PlacementResult& placement) const;
+
+private:
+  /**
+   * @brief Recompute the row terms of a range of rows
+   *
+   * @tparam Enabled The features whose row terms are computed
+   * @param board The board
+   * @param firstRow The first row to update
+   * @param lastRow The last row to update
+   */
+  template <FeatureMask Enabled = allFeatures>
+  void updateRows(const Board& board, int32_t firstRow, int32_t lastRow);
+
+  /**
+   * @brief Get the bumpiness term between a column and its right neighbour
+   *
+   * @param column The column index
+   * @return The absolute height difference
+   */
+  [[nodiscard]] int32_t bumpinessAt(int32_t column) const;
+
+  std::array<int8_t, maxHeight> m_rowTransitions{}; ///< Per-row transitions
+  std::array<int8_t, maxHeight>
+      m_columnTransitions{};                   ///< Transitions below each row
+  std::array<int8_t, maxHeight> m_wellCells{}; ///< Per-row well cells
+  std::array<int8_t, maxWidth> m_heights{};    ///< Column heights
+  int32_t m_width{};                           ///< Width of the board
+  int32_t m_aggregateHeight{};   ///< Sum of m_heights
+  int32_t m_maxHeight{};         ///< Highest column
+  int32_t m_bumpiness{};         ///< Sum of adjacent height differences
+  int32_t m_holes{};             ///< Covered empty cells
+  int32_t m_rowTransitionSum{};  ///< Sum of m_rowTransitions
+  int32_t m_columnTransitionSum{}; ///< Sum of m_columnTransitions
+  int32_t m_wellCellSum{};         ///< Sum of m_wellCells
+};
+
+template <FeatureMask Enabled>
+void BoardFeatures::compute(const Board& board) {
+  constexpr FeatureMask rowFeatures{featureBit(Feature::RowTransitions) |
+                                    featureBit(Feature::ColumnTransitions) |
+                                    featureBit(Feature::WellCells)};
+  constexpr FeatureMask heightFeatures{featureBit(Feature::AggregateHeight) |
+                                       featureBit(Feature::Bumpiness) |
+                                       featureBit(Feature::Holes)};
+
+  *this = BoardFeatures{};
+  m_width = board.getWidth();
+
+  // Row terms
+  if constexpr ((Enabled & rowFeatures) != 0) {
+    updateRows<Enabled>(board, 0, board.getHeight() - 1);
+    for (int32_t y{0}; y < board.getHeight(); ++y) {
+      m_rowTransitionSum += m_rowTransitions.at(y);
+      m_columnTransitionSum += m_columnTransitions.at(y);
+      m_wellCellSum += m_wellCells.at(y);
+    }
+  }
+
+  // Column terms
+  if constexpr ((Enabled & heightFeatures) != 0) {
+    for (int32_t x{0}; x < m_width; ++x) {
+      m_heights.at(x) = static_cast<int8_t>(board.getColumnHeight(x));
+      m_aggregateHeight += m_heights.at(x);
+    }
+  }
+  if constexpr ((Enabled & featureBit(Feature::Bumpiness)) != 0) {
+    for (int32_t x{0}; x + 1 < m_width; ++x) {
+      m_bumpiness += bumpinessAt(x);
+    }
+  }
+  if constexpr ((Enabled & featureBit(Feature::Holes)) != 0) {
+    m_holes = m_aggregateHeight - board.getFilledCellCount();
+  }
+
+  m_maxHeight = board.getRoof();
+}
+
+template <FeatureMask Enabled>
+void BoardFeatures::updateRows(const Board& board, const int32_t firstRow,
+                               const int32_t lastRow) {
+  const uint32_t fullRowMask{board.getFullRowMask()};
+  uint32_t below{firstRow > 0 ? board.getRow(firstRow - 1) : fullRowMask};
+
+  for (int32_t y{firstRow}; y <= lastRow; ++y) {
+    const uint32_t row{board.getRow(y)};
+    if constexpr ((Enabled & featureBit(Feature::RowTransitions)) != 0) {
+      m_rowTransitions.at(y) =
+          static_cast<int8_t>(rowTransitions(row, fullRowMask));
+    }
+    if constexpr ((Enabled & featureBit(Feature::ColumnTransitions)) != 0) {
+      m_columnTransitions.at(y) =
+          static_cast<int8_t>(columnTransitions(below, row, fullRowMask));
+    }
+    if constexpr ((Enabled & featureBit(Feature::WellCells)) != 0) {
+      m_wellCells.at(y) = static_cast<int8_t>(wellCells(row, fullRowMask));
+    }
+    below = row;
+  }
+}
+
+template <Feature F>
+int32_t BoardFeatures::get(const PlacementResult& placement) const {
+  if constexpr (F == Feature::AggregateHeight) {
+    return m_aggregateHeight;
+  } else if constexpr (F == Feature::MaxHeight) {
+    return m_maxHeight;
+  } else if constexpr (F == Feature::Bumpiness) {
+    return m_bumpiness;
+  } else if constexpr (F == Feature::Holes) {
+    return m_holes;
+  } else if constexpr (F == Feature::RowTransitions) {
+    return m_rowTransitionSum;
+  } else if constexpr (F == Feature::ColumnTransitions) {
+    return m_columnTransitionSum;
+  } else if constexpr (F == Feature::WellCells) {
+    return m_wellCellSum;
+  } else if constexpr (F == Feature::LinesCleared) {
+    return placement.linesCleared;
+  } else {
+    static_assert(F == Feature::TSpinLines, "Unhandled feature");
+    return placement.tSpinType != 0 ? placement.linesCleared : 0;
+  }
+}
+
+} // namespace tetris
@@ -0,0 +1,56 @@
+#include "cached_evaluator.hpp"
+#include "../core/zobrist.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+constexpr size_t maxKeyedLines{5};
+constexpr size_t keyedTSpinTypes{3};
+
+// Zobrist keys of the placement data a score depends on
+constexpr auto placementKeys{
+    tetris::makeZobristKeys<maxKeyedLines * keyedTSpinTypes>(0xE7A1CAC4EULL)};
+
+} // namespace
+
+namespace tetris {
+
+CachedEvaluator::CachedEvaluator(std::shared_ptr<const Evaluator> evaluator,
+                                 std::shared_ptr<EvalCache> cache)
+    : m_evaluator{std::move(evaluator)}, m_cache{std::move(cache)} {
+  [[unlikely]] if (!m_evaluator) {
+    throw std::invalid_argument("Evaluator cannot be null");
+  }
+  if (!m_cache) {
+    m_cache = std::make_shared<EvalCache>();
+  }
+}
+
+double CachedEvaluator::evaluate(const Board& board,
+                                 const BoardFeatures& features,
+                                 const PlacementResult& placement) const {
+  const uint64_t key{getCacheKey(board, placement)};
+  if (const auto cached{m_cache->probe(key)}) {
+    return *cached;
+  }
+
+  const double score{m_evaluator->evaluate(board, features, placement)};
+  m_cache->store(key, score);
+  return score;
+}
+
+uint64_t CachedEvaluator::getCacheKey(const Board& board,
+                                      const PlacementResult& placement) {
+  const auto lines{static_cast<size_t>(
+      std::clamp<int32_t>(placement.linesCleared, 0, maxKeyedLines - 1))};
+  const auto tSpinType{static_cast<size_t>(
+      std::clamp<int32_t>(placement.tSpinType, 0, keyedTSpinTypes - 1))};
+
+  return board.getZobristKey() ^
+         placementKeys[tSpinType * maxKeyedLines + lines];
+}
+
+} // namespace tetris
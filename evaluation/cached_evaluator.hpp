@@ -0,0 +1,85 @@
+#pragma once
+
+#include "eval_cache.hpp"
+#include "evaluator.hpp"
+#include <memory>
+#include <string_view>
+
+using namespace std::string_view_literals;
+
+namespace tetris {
+
+/**
+ * @class CachedEvaluator
+ * @brief Evaluator decorator that memoizes scores in an EvalCache
+ *
+ * The cache key is the board Zobrist key combined with the lines cleared and
+ * T-spin type of the placement, the only placement data a score depends on.
+ * The cache may be shared between evaluators wrapping the same inner
+ * evaluator.
+ */
+class CachedEvaluator final : public Evaluator {
+public:
+  /**
+   * @brief Construct a cached evaluator
+   *
+   * @param evaluator The evaluator computing scores on a miss
+   * @param cache The cache to use, a new default-sized one if null
+   * @throws std::invalid_argument if evaluator is null
+   */
+  explicit CachedEvaluator(std::shared_ptr<const Evaluator> evaluator,
+                           std::shared_ptr<EvalCache> cache = nullptr);
+
+  /**
+   * @brief Get the name of the evaluator
+   *
+   * @return The name "CachedEvaluator"
+   */
+  [[nodiscard]] std::string_view getName() const override {
+    return "CachedEvaluator"sv;
+  }
+
+  using Evaluator::evaluate;
+
+  /**
+   * @brief Evaluate a placement, using the cached score when present
+   *
+   * @param board The board after the placement
+   * @param features The features of that board
+   * @param placement The result of the placement
+   * @return The score of the inner evaluator
+   */
+  [[nodiscard]] double evaluate(const Board& board,
+                                const BoardFeatures& features,
+                                const PlacementResult& placement) const override;
+
+  /**
+   * @brief Get the cache key of a placement
+   *
+   * @param board The board after the placement
+   * @param placement The result of the placement
+   * @return The cache key
+   */
+  [[nodiscard]] static uint64_t getCacheKey(const Board& board,
+                                            const PlacementResult& placement);
+
+  /**
+   * @brief Get the cache
+   */
+  [[nodiscard]] const std::shared_ptr<EvalCache>& getCache() const {
+    return m_cache;
+  }
+
+  /**
+   * @brief Get the wrapped evaluator
+   */
+  [[nodiscard]] const std::shared_ptr<const Evaluator>& getEvaluator() const {
+    return m_evaluator;
+  }
+
+private:
+  std::shared_ptr<const Evaluator> m_evaluator; ///< Evaluator used on a miss
+  std::shared_ptr<EvalCache> m_cache;           ///< Score cache
+};
+
+} // namespace tetris
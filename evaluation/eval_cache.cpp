@@ -0,0 +1,102 @@
+#include "eval_cache.hpp"
+
+#include <bit>
+
+namespace tetris {
+
+namespace {
+
+/**
+ * @brief Source of the per-thread stripe indices
+ */
+std::atomic<size_t> nextThreadStripe{0};
+
+/**
+ * @brief Stripe index of the calling thread, assigned on first use
+ */
+thread_local const size_t threadStripe{
+    nextThreadStripe.fetch_add(1, std::memory_order_relaxed)};
+
+} // namespace
+
+EvalCache::EvalCache(const size_t bucketCount)
+    : m_buckets(std::bit_ceil(bucketCount == 0 ? size_t{1} : bucketCount)),
+      m_bucketMask{m_buckets.size() - 1} {}
+
+std::optional<double> EvalCache::probe(const uint64_t key) const {
+  for (const Entry& entry : getBucket(key).entries) {
+    const uint64_t scoreBits{entry.scoreBits.load(std::memory_order_relaxed)};
+    if ((entry.check.load(std::memory_order_relaxed) ^ scoreBits) == key) {
+      getStripe().hits.fetch_add(1, std::memory_order_relaxed);
+      return std::bit_cast<double>(scoreBits);
+    }
+  }
+
+  getStripe().misses.fetch_add(1, std::memory_order_relaxed);
+  return std::nullopt;
+}
+
+void EvalCache::store(const uint64_t key, const double score) {
+  auto& entries{m_buckets[key & m_bucketMask].entries};
+
+  // Reuse the entry of the key if present, otherwise replace the entry
+  // selected by the high bits of the key
+  Entry* target{&entries[key >> 62U]};
+  for (Entry& entry : entries) {
+    if ((entry.check.load(std::memory_order_relaxed) ^
+         entry.scoreBits.load(std::memory_order_relaxed)) == key) {
+      target = &entry;
+      break;
+    }
+  }
+
+  const auto scoreBits{std::bit_cast<uint64_t>(score)};
+  target->check.store(key ^ scoreBits, std::memory_order_relaxed);
+  target->scoreBits.store(scoreBits, std::memory_order_relaxed);
+}
+
+void EvalCache::clear() {
+  for (Bucket& bucket : m_buckets) {
+    for (Entry& entry : bucket.entries) {
+      entry.check.store(~uint64_t{0}, std::memory_order_relaxed);
+      entry.scoreBits.store(0, std::memory_order_relaxed);
+    }
+  }
+  resetStatistics();
+}
+
+uint64_t EvalCache::getHits() const {
+  uint64_t hits{0};
+  for (const Stripe& stripe : m_stripes) {
+    hits += stripe.hits.load(std::memory_order_relaxed);
+  }
+  return hits;
+}
+
+uint64_t EvalCache::getMisses() const {
+  uint64_t misses{0};
+  for (const Stripe& stripe : m_stripes) {
+    misses += stripe.misses.load(std::memory_order_relaxed);
+  }
+  return misses;
+}
+
+double EvalCache::getHitRate() const {
+  const uint64_t hits{getHits()};
+  const uint64_t lookups{hits + getMisses()};
+  return lookups == 0 ? 0.0
+                      : static_cast<double>(hits) / static_cast<double>(lookups);
+}
+
+void EvalCache::resetStatistics() {
+  for (Stripe& stripe : m_stripes) {
+    stripe.hits.store(0, std::memory_order_relaxed);
+    stripe.misses.store(0, std::memory_order_relaxed);
+  }
+}
+
+EvalCache::Stripe& EvalCache::getStripe() const {
+  return m_stripes[threadStripe % stripeCount];
+}
+
+} // namespace tetris
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace tetris {
+
+/**
+ * @class EvalCache
+ * @brief Fixed-size, lossy cache of evaluation scores keyed on a 64-bit key
+ *
+ * Entries are grouped in buckets of one cache line; a lookup touches a single
+ * line. A store into a full bucket overwrites an entry chosen by the key, so
+ * the cache never grows and never evicts more than one entry per store.
+ *
+ * Each entry stores the key XOR-ed with the score bits. A torn read from a
+ * concurrent store fails the key check and is reported as a miss, so one cache
+ * can be shared by several threads without locking. Hits and misses are
+ * counted in per-thread stripes of one cache line each, so counting does not
+ * make the threads write to a shared line on every lookup.
+ */
+class EvalCache {
+public:
+  /**
+   * @brief Default number of buckets
+   */
+  static constexpr size_t defaultBucketCount{size_t{1} << 16U};
+
+  /**
+   * @brief Construct a cache
+   *
+   * @param bucketCount The number of buckets, rounded up to a power of two
+   */
+  explicit EvalCache(size_t bucketCount = defaultBucketCount);
+
+  /**
+   * @brief Look up the score stored for a key
+   *
+   * @param key The key
+   * @return The score, or std::nullopt on a miss
+   */
+  [[nodiscard]] std::optional<double> probe(uint64_t key) const;
+
+  /**
+   * @brief Store the score of a key
+   *
+   * @param key The key
+   * @param score The score
+   */
+  void store(uint64_t key, double score);
+
+  /**
+   * @brief Remove all entries and reset the statistics
+   */
+  void clear();
+
+  /**
+   * @brief Get the number of entries the cache can hold
+   */
+  [[nodiscard]] size_t getCapacity() const {
+    return m_buckets.size() * entriesPerBucket;
+  }
+
+  /**
+   * @brief Get the number of successful lookups
+   */
+  [[nodiscard]] uint64_t getHits() const;
+
+  /**
+   * @brief Get the number of failed lookups
+   */
+  [[nodiscard]] uint64_t getMisses() const;
+
+  /**
+   * @brief Get the fraction of lookups that hit, 0 before any lookup
+   */
+  [[nodiscard]] double getHitRate() const;
+
+  /**
+   * @brief Reset the hit and miss counters
+   */
+  void resetStatistics();
+
+private:
+  /**
+   * @brief Number of entries sharing one cache line
+   */
+  static constexpr size_t entriesPerBucket{4};
+
+  /**
+   * @brief Number of counter stripes, threads beyond it share stripes
+   */
+  static constexpr size_t stripeCount{16};
+
+  /**
+   * @brief A cached score, verified by XOR-ing its two words
+   */
+  struct Entry {
+    std::atomic<uint64_t> check{~uint64_t{0}}; ///< key ^ scoreBits
+    std::atomic<uint64_t> scoreBits{0};        ///< Bit pattern of the score
+  };
+
+  /**
+   * @brief One cache line of entries
+   */
+  struct alignas(64) Bucket {
+    std::array<Entry, entriesPerBucket> entries;
+  };
+
+  /**
+   * @brief Lookup counters of the threads mapped to one stripe
+   */
+  struct alignas(64) Stripe {
+    std::atomic<uint64_t> hits{0};   ///< Successful lookups
+    std::atomic<uint64_t> misses{0}; ///< Failed lookups
+  };
+
+  /**
+   * @brief Get the counter stripe of the calling thread
+   */
+  [[nodiscard]] Stripe& getStripe() const;
+
+  /**
+   * @brief Get the bucket of a key
+   */
+  [[nodiscard]] const Bucket& getBucket(uint64_t key) const {
+    return m_buckets[key & m_bucketMask];
+  }
+
+  std::vector<Bucket> m_buckets;                     ///< Cache storage
+  uint64_t m_bucketMask{};                           ///< Bucket count - 1
+  mutable std::array<Stripe, stripeCount> m_stripes; ///< Lookup counters
+};
+
+} // namespace tetris
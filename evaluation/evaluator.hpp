@@ -0,0 +1,57 @@
+#pragma once
+
+#include "../core/placement.hpp"
+#include "../core/tetris_board.hpp"
+#include "board_features.hpp"
+#include <string_view>
+
+namespace tetris {
+
+/**
+ * @class Evaluator
+ * @brief Abstract interface for placement evaluators
+ *
+ * An evaluator scores the board produced by a placement; higher scores are
+ * better. Search engines keep the BoardFeatures of each node and update them
+ * incrementally, so evaluators receive the features alongside the board.
+ */
+class Evaluator {
+public:
+  /**
+   * @brief Virtual destructor
+   */
+  virtual ~Evaluator() = default;
+
+  /**
+   * @brief Get the name of the evaluator
+   *
+   * @return The name of the evaluator
+   */
+  [[nodiscard]] virtual std::string_view getName() const = 0;
+
+  /**
+   * @brief Evaluate a placement
+   *
+   * @param board The board after the placement
+   * @param features The features of that board
+   * @param placement The result of the placement
+   * @return The score of the placement, higher is better
+   */
+  [[nodiscard]] virtual double evaluate(const Board& board,
+                                        const BoardFeatures& features,
+                                        const PlacementResult& placement) const = 0;
+
+  /**
+   * @brief Evaluate a placement, computing the board features from scratch
+   *
+   * @param board The board after the placement
+   * @param placement The result of the placement
+   * @return The score of the placement, higher is better
+   */
+  [[nodiscard]] double evaluate(const Board& board,
+                                const PlacementResult& placement) const {
+    return evaluate(board, BoardFeatures{board}, placement);
+  }
+};
+
+} // namespace tetris
@@ -0,0 +1,23 @@
+#include "linear_evaluator.hpp"
+
+namespace tetris {
+
+LinearEvaluator::LinearEvaluator() : m_weights{defaultWeights} {}
+
+LinearEvaluator::LinearEvaluator(const Weights& weights)
+    : m_weights{weights} {}
+
+double LinearEvaluator::evaluate(const Board& /*board*/,
+                                 const BoardFeatures& features,
+                                 const PlacementResult& placement) const {
+  const FeatureVector values{features.getFeatureVector(placement)};
+
+  double score{0.0};
+  for (size_t i{0}; i < featureCount; ++i) {
+    score += m_weights.at(i) * values.at(i);
+  }
+
+  return score;
+}
+
+} // namespace tetris
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "evaluator.hpp"
+#include <array>
+#include <string_view>
+
+using namespace std::string_view_literals;
+
+namespace tetris {
+
+/**
+ * @class LinearEvaluator
+ * @brief Evaluator scoring a placement as a weighted sum of its features
+ */
+class LinearEvaluator final : public Evaluator {
+public:
+  /**
+   * @brief Weight of every feature, indexed by Feature
+   */
+  using Weights = std::array<double, featureCount>;
+
+  /**
+   * @brief Default weights, a hand-tuned starting point
+   */
+  static constexpr Weights defaultWeights{{
+      -0.51, // AggregateHeight
+      -0.30, // MaxHeight
+      -0.18, // Bumpiness
+      -3.50, // Holes
+      -0.90, // RowTransitions
+      -2.20, // ColumnTransitions
+      -0.25, // WellCells
+      0.76,  // LinesCleared
+      4.00,  // TSpinLines
+  }};
+
+  /**
+   * @brief Construct with the default weights
+   */
+  LinearEvaluator();
+
+  /**
+   * @brief Construct with the given weights
+   *
+   * @param weights The feature weights
+   */
+  explicit LinearEvaluator(const Weights& weights);
+
+  /**
+   * @brief Get the name of the evaluator
+   *
+   * @return The name "LinearEvaluator"
+   */
+  [[nodiscard]] std::string_view getName() const override {
+    return "LinearEvaluator"sv;
+  }
+
+  using Evaluator::evaluate;
+
+  /**
+   * @brief Evaluate a placement
+   *
+   * @param board The board after the placement
+   * @param features The features of that board
+   * @param placement The result of the placement
+   * @return The weighted sum of the feature values
+   */
+  [[nodiscard]] double evaluate(const Board& board,
+                                const BoardFeatures& features,
+                                const PlacementResult& placement) const override;
+
+  /**
+   * @brief Get the feature weights
+   */
+  [[nodiscard]] const Weights& getWeights() const { return m_weights; }
+
+  /**
+   * @brief Set the feature weights
+   */
+  void setWeights(const Weights& weights) { m_weights = weights; }
+
+private:
+  Weights m_weights; ///< Weight of every feature
+};
+
+} // namespace tetris
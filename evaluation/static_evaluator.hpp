@@ -0,0 +1,128 @@
+#pragma once
+
+#include "board_features.hpp"
+#include "evaluator.hpp"
+#include "linear_evaluator.hpp"
+#include <concepts>
+#include <string_view>
+#include <utility>
+
+using namespace std::string_view_literals;
+
+namespace tetris {
+
+/**
+ * @brief A type carrying a weight set as a compile-time constant
+ *
+ * Example:
+ * @code
+ * struct MyWeights {
+ *   static constexpr LinearEvaluator::Weights weights{...};
+ * };
+ * StaticEvaluator<MyWeights> evaluator;
+ * @endcode
+ */
+template <typename T>
+concept WeightSet = requires {
+  { T::weights } -> std::convertible_to<const LinearEvaluator::Weights&>;
+};
+
+/**
+ * @brief Weight set holding LinearEvaluator::defaultWeights
+ */
+struct DefaultWeightSet {
+  static constexpr LinearEvaluator::Weights weights{
+      LinearEvaluator::defaultWeights};
+};
+
+/**
+ * @class StaticEvaluator
+ * @brief Linear evaluator whose weights are fixed at compile time
+ *
+ * The weighted sum is unrolled over the features, so features with a zero
+ * weight are dropped entirely and the remaining multiplications use constant
+ * operands. Scores match a LinearEvaluator holding the same weights, which
+ * remains the path to use while tuning.
+ *
+ * @tparam W The weight set
+ */
+template <WeightSet W> class StaticEvaluator final : public Evaluator {
+public:
+  /**
+   * @brief Mask of the features with a non-zero weight
+   */
+  static constexpr FeatureMask enabledFeatures{
+      []<size_t... I>(std::index_sequence<I...>) {
+        return ((W::weights[I] != 0.0 ? FeatureMask{1} << I : FeatureMask{0}) |
+                ...);
+      }(std::make_index_sequence<featureCount>{})};
+
+  /**
+   * @brief Get the name of the evaluator
+   *
+   * @return The name "StaticEvaluator"
+   */
+  [[nodiscard]] std::string_view getName() const override {
+    return "StaticEvaluator"sv;
+  }
+
+  /**
+   * @brief Evaluate a placement
+   *
+   * @param board The board after the placement
+   * @param features The features of that board
+   * @param placement The result of the placement
+   * @return The weighted sum of the enabled feature values
+   */
+  [[nodiscard]] double evaluate(const Board& board,
+                                const BoardFeatures& features,
+                                const PlacementResult& placement) const override {
+    return score(board, features, placement);
+  }
+
+  /**
+   * @brief Evaluate a placement, computing only the enabled features
+   *
+   * @param board The board after the placement
+   * @param placement The result of the placement
+   * @return The weighted sum of the enabled feature values
+   */
+  [[nodiscard]] double evaluate(const Board& board,
+                                const PlacementResult& placement) const {
+    BoardFeatures features{};
+    features.compute<enabledFeatures>(board);
+    return score(board, features, placement);
+  }
+
+  /**
+   * @brief Non-virtual scoring, for engines templated on the evaluator
+   *
+   * @param board The board after the placement
+   * @param features The features of that board
+   * @param placement The result of the placement
+   * @return The weighted sum of the enabled feature values
+   */
+  [[nodiscard]] static double score(const Board& /*board*/,
+                                    const BoardFeatures& features,
+                                    const PlacementResult& placement) {
+    return [&]<size_t... I>(std::index_sequence<I...>) {
+      return (0.0 + ... + term<I>(features, placement));
+    }(std::make_index_sequence<featureCount>{});
+  }
+
+private:
+  /**
+   * @brief Weighted value of one feature, or 0 when the weight is 0
+   */
+  template <size_t I>
+  [[nodiscard]] static double term(const BoardFeatures& features,
+                                   const PlacementResult& placement) {
+    if constexpr (constexpr double weight{W::weights[I]}; weight == 0.0) {
+      return 0.0;
+    } else {
+      return weight * features.get<static_cast<Feature>(I)>(placement);
+    }
+  }
+};
+
+} // namespace tetris
@@ -0,0 +1,51 @@
+#include "bag_randomizer.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace tetris {
+
+BagRandomizer::BagRandomizer(const uint64_t seed) : BagRandomizer{seed, 1} {}
+
+BagRandomizer::BagRandomizer(const uint64_t seed, const int32_t copies)
+    : m_copies{copies} {
+  [[unlikely]] if (copies < 1 || copies > maxCopies) {
+    throw std::invalid_argument("Bag copies must be between 1 and maxCopies");
+  }
+  m_size = static_cast<uint32_t>(pieceTypeCount) *
+           static_cast<uint32_t>(copies);
+  reset(seed);
+}
+
+std::string BagRandomizer::getName() const {
+  return std::to_string(m_size) + "-bag";
+}
+
+void BagRandomizer::reset(const uint64_t seed) {
+  m_state = seed;
+  m_position = m_size;
+  m_counts.fill(0);
+}
+
+uint8_t BagRandomizer::getCandidateMask() const {
+  uint8_t mask{0};
+  for (size_t type{0}; type < pieceTypeCount; ++type) {
+    mask |= static_cast<uint8_t>(m_counts.at(type) != 0 ? 1U << type : 0U);
+  }
+  return mask != 0 ? mask : BagState::fullMask;
+}
+
+void BagRandomizer::refill() {
+  for (uint32_t i{0}; i < m_size; ++i) {
+    m_bag.at(i) = static_cast<PieceType>(i % pieceTypeCount);
+  }
+  m_counts.fill(static_cast<uint8_t>(m_copies));
+
+  // Fisher-Yates, from the back
+  for (uint32_t i{m_size - 1}; i > 0; --i) {
+    std::swap(m_bag.at(i), m_bag.at(drawBelow(m_state, i + 1)));
+  }
+  m_position = 0;
+}
+
+} // namespace tetris
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "../core/bag_state.hpp"
+#include "randomizer.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace tetris {
+
+/**
+ * @class BagRandomizer
+ * @brief Randomizer dealing shuffled bags of every piece type
+ *
+ * A bag holds each piece type a fixed number of times: once for the guideline
+ * 7-bag, twice for a 14-bag. The bag is shuffled when it is filled and then
+ * dealt in order, so dealing a piece is an array read and only every bag size
+ * pieces takes a branch into the shuffle.
+ */
+class BagRandomizer final : public Randomizer {
+public:
+  /**
+   * @brief Maximum number of copies of each piece type in a bag
+   */
+  static constexpr int32_t maxCopies{4};
+
+  /**
+   * @brief Construct a 7-bag randomizer
+   *
+   * @param seed The seed
+   */
+  explicit BagRandomizer(uint64_t seed = 0);
+
+  /**
+   * @brief Construct a randomizer with several copies of each piece per bag
+   *
+   * @param seed The seed
+   * @param copies The number of copies of each piece type in a bag
+   * @throws std::invalid_argument if copies is not in [1, maxCopies]
+   */
+  BagRandomizer(uint64_t seed, int32_t copies);
+
+  /**
+   * @brief Get the name of the randomizer
+   * @return "7-bag" for one copy per bag, "14-bag" for two and so on
+   */
+  [[nodiscard]] std::string getName() const override;
+
+  /**
+   * @brief Restart the sequence from a seed
+   *
+   * @param seed The seed
+   */
+  void reset(uint64_t seed) override;
+
+  /**
+   * @brief Deal the next piece
+   *
+   * @return The piece
+   */
+  PieceType next() override {
+    [[unlikely]] if (m_position == m_size) {
+      refill();
+    }
+    const PieceType type{m_bag[m_position++]};
+    --m_counts[static_cast<size_t>(type)];
+    return type;
+  }
+
+  /**
+   * @brief Get the piece types the next piece can be
+   *
+   * @return The types left in the bag, every type once it is empty
+   */
+  [[nodiscard]] uint8_t getCandidateMask() const override;
+
+  /**
+   * @brief Clone the randomizer, including its position in the sequence
+   *
+   * @return A copy of the randomizer
+   */
+  [[nodiscard]] std::shared_ptr<Randomizer> clone() const override {
+    return std::make_shared<BagRandomizer>(*this);
+  }
+
+  /**
+   * @brief Get the number of copies of a piece type left in the bag
+   *
+   * @param type The piece type
+   * @return The count, 0 once the bag is empty
+   */
+  [[nodiscard]] int32_t getRemainingCount(PieceType type) const {
+    return m_counts.at(static_cast<size_t>(type));
+  }
+
+  /**
+   * @brief Get the number of pieces left in the bag
+   */
+  [[nodiscard]] int32_t getRemainingSize() const {
+    return static_cast<int32_t>(m_size - m_position);
+  }
+
+  /**
+   * @brief Get the bag as a set of remaining piece types
+   *
+   * Exact for a 7-bag; with more copies it only tells which types are left.
+   *
+   * @return The bag state, full once the bag is empty
+   */
+  [[nodiscard]] BagState getBagState() const {
+    return BagState{getCandidateMask()};
+  }
+
+  /**
+   * @brief Get the number of copies of each piece type per bag
+   */
+  [[nodiscard]] int32_t getCopies() const { return m_copies; }
+
+private:
+  /**
+   * @brief Fill the bag and shuffle it
+   */
+  void refill();
+
+  std::array<PieceType, pieceTypeCount * maxCopies>
+      m_bag{};                                    ///< Shuffled bag
+  std::array<uint8_t, pieceTypeCount> m_counts{}; ///< Copies left by type
+  uint64_t m_state{0};                            ///< Generator state
+  uint32_t m_size{0};                             ///< Number of pieces per bag
+  uint32_t m_position{0};                         ///< Index of the next piece
+  int32_t m_copies{1};                            ///< Copies of each type
+};
+
+} // namespace tetris
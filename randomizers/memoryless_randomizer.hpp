@@ -0,0 +1,70 @@
+#pragma once
+
+#include "../core/bag_state.hpp"
+#include "randomizer.hpp"
+#include <cstdint>
+
+namespace tetris {
+
+/**
+ * @class MemorylessRandomizer
+ * @brief Randomizer dealing every piece type with equal chance
+ *
+ * Each piece is drawn independently of the ones before it, as in classic
+ * games without a bag.
+ */
+class MemorylessRandomizer final : public Randomizer {
+public:
+  /**
+   * @brief Construct a memoryless randomizer
+   *
+   * @param seed The seed
+   */
+  explicit MemorylessRandomizer(const uint64_t seed = 0) : m_state{seed} {}
+
+  /**
+   * @brief Get the name of the randomizer
+   * @return "memoryless"
+   */
+  [[nodiscard]] std::string getName() const override { return "memoryless"; }
+
+  /**
+   * @brief Restart the sequence from a seed
+   *
+   * @param seed The seed
+   */
+  void reset(const uint64_t seed) override { m_state = seed; }
+
+  /**
+   * @brief Deal the next piece
+   *
+   * @return The piece
+   */
+  PieceType next() override {
+    return static_cast<PieceType>(
+        drawBelow(m_state, static_cast<uint32_t>(pieceTypeCount)));
+  }
+
+  /**
+   * @brief Get the piece types the next piece can be
+   *
+   * @return Every piece type
+   */
+  [[nodiscard]] uint8_t getCandidateMask() const override {
+    return BagState::fullMask;
+  }
+
+  /**
+   * @brief Clone the randomizer, including its position in the sequence
+   *
+   * @return A copy of the randomizer
+   */
+  [[nodiscard]] std::shared_ptr<Randomizer> clone() const override {
+    return std::make_shared<MemorylessRandomizer>(*this);
+  }
+
+private:
+  uint64_t m_state{0}; ///< Generator state
+};
+
+} // namespace tetris
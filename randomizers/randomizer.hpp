@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../core/piece_queue.hpp"
+#include "../core/tetris_piece.hpp"
+#include "../core/zobrist.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace tetris {
+
+/**
+ * @brief Draw a value below a bound from a SplitMix64 state
+ *
+ * Multiplies the high half of the next value by the bound instead of taking a
+ * remainder, so drawing has no division and no rejection loop. The bias is
+ * below bound / 2^32.
+ *
+ * @param state The generator state, updated in place
+ * @param bound The number of possible values, at most 2^32 - 1
+ * @return A value in [0, bound)
+ */
+[[nodiscard]] inline uint32_t drawBelow(uint64_t& state, const uint32_t bound) {
+  return static_cast<uint32_t>(((splitMix64(state) >> 32U) * bound) >> 32U);
+}
+
+/**
+ * @class Randomizer
+ * @brief Abstract interface for piece randomizers
+ *
+ * A randomizer deals the piece sequence of a game from a 64-bit seed; the
+ * same seed always deals the same sequence. Implementations are final, so
+ * callers holding the concrete type draw pieces without virtual calls.
+ */
+class Randomizer {
+public:
+  /**
+   * @brief Virtual destructor
+   */
+  virtual ~Randomizer() = default;
+
+  /**
+   * @brief Get the name of the randomizer
+   *
+   * @return The name of the randomizer
+   */
+  [[nodiscard]] virtual std::string getName() const = 0;
+
+  /**
+   * @brief Restart the sequence from a seed
+   *
+   * @param seed The seed
+   */
+  virtual void reset(uint64_t seed) = 0;
+
+  /**
+   * @brief Deal the next piece
+   *
+   * @return The piece
+   */
+  virtual PieceType next() = 0;
+
+  /**
+   * @brief Get the piece types the next piece can be
+   *
+   * @return Mask with bit i set if PieceType i can be dealt next
+   */
+  [[nodiscard]] virtual uint8_t getCandidateMask() const = 0;
+
+  /**
+   * @brief Clone the randomizer, including its position in the sequence
+   *
+   * @return A copy of the randomizer
+   */
+  [[nodiscard]] virtual std::shared_ptr<Randomizer> clone() const = 0;
+
+  /**
+   * @brief Deal pieces into a queue until it holds a number of pieces
+   *
+   * @param queue The queue
+   * @param size The number of pieces the queue should hold
+   * @throws std::length_error if size exceeds the queue capacity
+   */
+  void fill(PieceQueue& queue, const size_t size) {
+    while (queue.size() < size) {
+      queue.push_back(next());
+    }
+  }
+};
+
+} // namespace tetris
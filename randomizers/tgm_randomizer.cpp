@@ -0,0 +1,89 @@
+#include "tgm_randomizer.hpp"
+#include "../core/bag_state.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace tetris {
+
+namespace {
+
+/**
+ * @brief Pieces the first piece is drawn from
+ */
+constexpr std::array firstPieces{PieceType::I, PieceType::J, PieceType::L,
+                                 PieceType::T};
+
+/**
+ * @brief Get the mask bit of a piece type
+ */
+uint8_t getPieceBit(const PieceType type) {
+  return static_cast<uint8_t>(1U << static_cast<uint32_t>(
+                                  std::to_underlying(type)));
+}
+
+} // namespace
+
+TgmRandomizer::TgmRandomizer(const uint64_t seed) : TgmRandomizer{seed, 4} {}
+
+TgmRandomizer::TgmRandomizer(const uint64_t seed, const int32_t rolls)
+    : m_rolls{rolls} {
+  [[unlikely]] if (rolls < 1) {
+    throw std::invalid_argument("TGM randomizer needs at least one roll");
+  }
+  reset(seed);
+}
+
+void TgmRandomizer::reset(const uint64_t seed) {
+  m_state = seed;
+  m_history.fill(PieceType::Z);
+  m_firstPiece = true;
+}
+
+PieceType TgmRandomizer::next() {
+  PieceType type{};
+  [[unlikely]] if (m_firstPiece) {
+    type = firstPieces.at(
+        drawBelow(m_state, static_cast<uint32_t>(firstPieces.size())));
+    m_firstPiece = false;
+  } else {
+    uint8_t historyMask{0};
+    for (const PieceType recent : m_history) {
+      historyMask |= getPieceBit(recent);
+    }
+
+    // Every roll is drawn and the first fresh piece selected without
+    // branching on the draws, which are unpredictable
+    uint64_t state{m_state};
+    uint32_t fresh{pieceTypeCount};
+    uint32_t drawn{0};
+    for (int32_t roll{0}; roll < m_rolls; ++roll) {
+      drawn = drawBelow(state, static_cast<uint32_t>(pieceTypeCount));
+      const uint32_t isFresh{((historyMask >> drawn) & 1U) ^ 1U};
+      const uint32_t select{
+          0U - (static_cast<uint32_t>(fresh == pieceTypeCount) & isFresh)};
+      fresh = (drawn & select) | (fresh & ~select);
+    }
+    m_state = state;
+    type = static_cast<PieceType>(fresh == pieceTypeCount ? drawn : fresh);
+  }
+
+  for (size_t i{1}; i < historySize; ++i) {
+    m_history.at(i - 1) = m_history.at(i);
+  }
+  m_history.back() = type;
+  return type;
+}
+
+uint8_t TgmRandomizer::getCandidateMask() const {
+  if (!m_firstPiece) {
+    return BagState::fullMask;
+  }
+  uint8_t mask{0};
+  for (const PieceType type : firstPieces) {
+    mask |= getPieceBit(type);
+  }
+  return mask;
+}
+
+} // namespace tetris
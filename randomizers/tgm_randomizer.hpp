@@ -0,0 +1,97 @@
+#pragma once
+
+#include "randomizer.hpp"
+#include <array>
+#include <cstdint>
+
+namespace tetris {
+
+/**
+ * @class TgmRandomizer
+ * @brief Randomizer of The Grand Master, avoiding recently dealt pieces
+ *
+ * The randomizer remembers the last four pieces. Each piece is drawn a fixed
+ * number of times and the first draw not in the history is dealt; if every
+ * draw is in the history the last one is dealt anyway. The history
+ * starts as four Z pieces and the first piece is never S, Z or O, so the game
+ * does not open with an overhang.
+ */
+class TgmRandomizer final : public Randomizer {
+public:
+  /**
+   * @brief Number of pieces remembered
+   */
+  static constexpr size_t historySize{4};
+
+  /**
+   * @brief Construct a randomizer drawing four times, as in the first game
+   *
+   * @param seed The seed
+   */
+  explicit TgmRandomizer(uint64_t seed = 0);
+
+  /**
+   * @brief Construct a randomizer
+   *
+   * @param seed The seed
+   * @param rolls The number of draws per piece, 6 in the second game
+   * @throws std::invalid_argument if rolls is not positive
+   */
+  TgmRandomizer(uint64_t seed, int32_t rolls);
+
+  /**
+   * @brief Get the name of the randomizer
+   * @return "TGM"
+   */
+  [[nodiscard]] std::string getName() const override { return "TGM"; }
+
+  /**
+   * @brief Restart the sequence from a seed
+   *
+   * @param seed The seed
+   */
+  void reset(uint64_t seed) override;
+
+  /**
+   * @brief Deal the next piece
+   *
+   * @return The piece
+   */
+  PieceType next() override;
+
+  /**
+   * @brief Get the piece types the next piece can be
+   *
+   * @return I, J, L and T for the first piece, every type afterwards
+   */
+  [[nodiscard]] uint8_t getCandidateMask() const override;
+
+  /**
+   * @brief Clone the randomizer, including its position in the sequence
+   *
+   * @return A copy of the randomizer
+   */
+  [[nodiscard]] std::shared_ptr<Randomizer> clone() const override {
+    return std::make_shared<TgmRandomizer>(*this);
+  }
+
+  /**
+   * @brief Get the last pieces dealt, oldest first
+   */
+  [[nodiscard]] const std::array<PieceType, historySize>& getHistory() const {
+    return m_history;
+  }
+
+  /**
+   * @brief Get the number of draws per piece
+   */
+  [[nodiscard]] int32_t getRolls() const { return m_rolls; }
+
+private:
+  std::array<PieceType, historySize> m_history{}; ///< Last pieces, oldest first
+  uint64_t m_state{0};                            ///< Generator state
+  int32_t m_rolls{4};                             ///< Draws per piece
+  bool m_firstPiece{true};                        ///< Whether nothing was dealt
+};
+
+} // namespace tetris
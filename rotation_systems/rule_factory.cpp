@@ -1,7 +1,12 @@
 #include "rule_factory.hpp"
+
+#include "srs.hpp"
+
 #include <algorithm>
 #include <ranges>
 
+using namespace std::string_view_literals;
+
 namespace tetris {
 
 RuleFactory& RuleFactory::getInstance() {
@@ -13,7 +18,7 @@ RuleFactory::RuleFactory() { initialize(); }
 
 void RuleFactory::initialize() {
   // Register built-in rotation systems
-  // registerRotationSystem("SRS", std::make_unique<SRS>());
+  registerRotationSystem("SRS"sv, std::make_unique<SRS>());
 
   // Additional rotation systems can be registered here
   // Example usage:
@@ -57,7 +57,7 @@ private:
   /**
    * @brief Initialize the factory with built-in rotation systems
    */
-  static void initialize();
+  void initialize();
 
   std::unordered_map<std::string_view, std::unique_ptr<RotationSystem>>
       m_rotationSystems;
@@ -0,0 +1,370 @@
+#include "beam_search.hpp"
+#include "../core/zobrist.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace tetris {
+
+namespace {
+
+/**
+ * @brief Check whether a landing is tried before another
+ *
+ * Spins and line clears come first, then lower placements, which tend to
+ * keep the stack flat.
+ */
+bool isOrderedBefore(const LandingPosition* lhs, const LandingPosition* rhs) {
+  const auto getClearRank{[](const LandingPosition* landing) {
+    return landing->getLinesCleared() + (landing->isTSpin() ? maxLinesPerClear
+                                                            : 0);
+  }};
+  const int32_t lhsRank{getClearRank(lhs)};
+  const int32_t rhsRank{getClearRank(rhs)};
+  if (lhsRank != rhsRank) {
+    return lhsRank > rhsRank;
+  }
+  return lhs->getPiece().getState().getPosition().yPos <
+         rhs->getPiece().getState().getPosition().yPos;
+}
+
+} // namespace
+
+BeamSearch::BeamSearch(std::shared_ptr<const SearchAlgorithm> movegen,
+                       std::shared_ptr<const Evaluator> evaluator,
+                       const AttackTable& attackTable)
+    : BeamSearch{std::move(movegen), std::move(evaluator), attackTable,
+                 Config{}} {}
+
+BeamSearch::BeamSearch(std::shared_ptr<const SearchAlgorithm> movegen,
+                       std::shared_ptr<const Evaluator> evaluator,
+                       const AttackTable& attackTable, const Config& config)
+    : m_movegen{std::move(movegen)}, m_evaluator{std::move(evaluator)},
+      m_attackTable{attackTable}, m_config{config} {
+  [[unlikely]] if (!m_movegen || !m_evaluator) {
+    throw std::invalid_argument("Move generator and evaluator cannot be null");
+  }
+}
+
+std::optional<BeamSearch::Result>
+BeamSearch::search(const GameState& gameState) {
+  return search(gameState, SearchDeadline{});
+}
+
+std::optional<BeamSearch::Result>
+BeamSearch::search(const GameState& gameState,
+                   const SearchDeadline& deadline) {
+  m_expandedNodeCount = 0;
+  m_prunedNodeCount = 0;
+  if (gameState.isGameOver() || !gameState.getRotationSystem()) {
+    return std::nullopt;
+  }
+
+  // The piece sequence is the current piece followed by the preview
+  m_sequence.clear();
+  m_sequence.push_back(gameState.getCurrentPiece().getState().getType());
+  m_sequence.insert(m_sequence.end(), gameState.getNextPieces().begin(),
+                    gameState.getNextPieces().end());
+  m_rootHoldUsed = gameState.isHoldUsed();
+  m_rootMoves.clear();
+
+  // One scratch state per thread that may expand nodes. Landing generation
+  // only reads the board, which is overwritten for every node, so the states
+  // are kept across searches until the slots or rotation system change
+  const size_t slotCount{m_executor ? m_executor->getThreadCount() + 1 : 1};
+  if (m_scratch.size() != slotCount ||
+      m_scratch.front().getRotationSystem() !=
+          gameState.getRotationSystem()) {
+    m_scratch.clear();
+    for (size_t slot{0}; slot < slotCount; ++slot) {
+      m_scratch.push_back(gameState.clone());
+    }
+  }
+  m_beamStates.clear();
+  const uint64_t rootKey{gameState.getHash()};
+  if (m_table) {
+    m_table->newSearch();
+    m_table->prefetch(rootKey);
+  }
+
+  // One arena for the whole search, sized so that it never reallocates
+  const size_t depth{std::min(m_config.depth, m_sequence.size())};
+  m_arena.clear();
+  m_arena.reserve(1 + depth * m_config.beamWidth);
+
+  Node& root{m_arena.emplace_back(gameState.getBoard(),
+                                  BoardFeatures{gameState.getBoard()})};
+  root.held = gameState.getHeldPiece();
+  root.combo = gameState.getCombo();
+  root.backToBack = gameState.isBackToBack();
+
+  std::vector<uint32_t> beam{0};
+  std::vector<uint32_t> nextBeam{};
+  std::vector<Candidate> candidates{};
+  size_t bestDepth{0};
+
+  const SearchDeadline unlimited{};
+  for (size_t ply{1}; ply <= depth && !beam.empty(); ++ply) {
+    // The first ply always completes; a later ply cut short by the deadline
+    // would rank states on partial landing lists, so it is dropped
+    if (ply > 1 && deadline.checkNow()) {
+      break;
+    }
+    expandBeam(beam, ply == 1 ? unlimited : deadline, candidates);
+    if (ply > 1 && deadline.checkNow()) {
+      break;
+    }
+    if (candidates.empty()) {
+      break;
+    }
+
+    selectBeam(candidates, nextBeam);
+    std::swap(beam, nextBeam);
+    bestDepth = ply;
+
+    // The root moves are known now; a search of this state at least as deep
+    // already chose among them
+    if (ply == 1 && m_table) {
+      const auto entry{m_table->probe(rootKey)};
+      if (entry.has_value() && entry->depth >= depth &&
+          entry->move < m_rootMoves.size()) {
+        const RootMove& rootMove{m_rootMoves.at(entry->move)};
+        return Result{.landing = rootMove.landing,
+                      .useHold = rootMove.useHold,
+                      .score = entry->score,
+                      .depth = entry->depth};
+      }
+    }
+  }
+
+  if (bestDepth == 0) {
+    return std::nullopt;
+  }
+
+  // The beam is sorted, so its front is the best state of the deepest ply
+  const Node& best{m_arena.at(beam.front())};
+  const RootMove& rootMove{m_rootMoves.at(best.rootMove)};
+  if (m_table) {
+    m_table->store(rootKey, static_cast<float>(best.score),
+                   static_cast<uint8_t>(bestDepth),
+                   static_cast<uint16_t>(best.rootMove));
+  }
+  return Result{.landing = rootMove.landing,
+                .useHold = rootMove.useHold,
+                .score = best.score,
+                .depth = bestDepth};
+}
+
+void BeamSearch::expandBeam(const std::vector<uint32_t>& beam,
+                            const SearchDeadline& deadline,
+                            std::vector<Candidate>& candidates) {
+  if (m_nodeCandidates.size() < beam.size()) {
+    m_nodeCandidates.resize(beam.size());
+  }
+
+  // The beam is sorted, so futility compares with its front and the rank of
+  // a node decides its reduction
+  const double futilityBound{m_config.futilityMargin > 0.0
+                                 ? m_arena.at(beam.front()).score -
+                                       m_config.futilityMargin
+                                 : -std::numeric_limits<double>::infinity()};
+  const auto isPruned{[&](const size_t i) {
+    return m_arena.at(beam.at(i)).score < futilityBound;
+  }};
+
+  // Nodes only read the arena, and the root ply is a single node, so the
+  // root moves are only ever appended by one thread. Every node polls its
+  // own copy of the deadline.
+  const auto expandNode{[&](const size_t i) {
+    const SearchDeadline nodeDeadline{deadline};
+    m_nodeCandidates.at(i).clear();
+    if (isPruned(i)) {
+      return;
+    }
+    const bool reduced{m_config.lateMoveStart > 0 &&
+                       i >= m_config.lateMoveStart};
+    expand(beam.at(i), reduced, nodeDeadline, m_nodeCandidates.at(i));
+  }};
+  if (m_executor) {
+    m_executor->parallelFor(beam.size(), expandNode);
+  } else {
+    for (size_t i{0}; i < beam.size(); ++i) {
+      expandNode(i);
+    }
+  }
+
+  // Merge in beam order, the same order a single thread would produce
+  candidates.clear();
+  for (size_t i{0}; i < beam.size(); ++i) {
+    const std::vector<Candidate>& children{m_nodeCandidates.at(i)};
+    candidates.insert(candidates.end(), children.begin(), children.end());
+    if (isPruned(i)) {
+      ++m_prunedNodeCount;
+    } else if (m_arena.at(beam.at(i)).queueIndex <
+               static_cast<int32_t>(m_sequence.size())) {
+      ++m_expandedNodeCount;
+    }
+  }
+}
+
+void BeamSearch::expand(const uint32_t nodeIndex, const bool reduced,
+                        const SearchDeadline& deadline,
+                        std::vector<Candidate>& candidates) {
+  const Node& node{m_arena.at(nodeIndex)};
+  const int32_t queueIndex{node.queueIndex};
+  const auto sequenceSize{static_cast<int32_t>(m_sequence.size())};
+  if (queueIndex >= sequenceSize) {
+    return;
+  }
+
+  const PieceType current{m_sequence.at(queueIndex)};
+  const std::optional<PieceType> held{node.held};
+
+  // Place the next piece of the sequence
+  const size_t landingLimit{reduced ? m_config.lateMoveChildren
+                                    : std::numeric_limits<size_t>::max()};
+  expandPiece(nodeIndex, current, held, queueIndex + 1, false, landingLimit,
+              deadline, candidates);
+
+  // Hold it and place the held piece, or the one after it if hold is empty;
+  // reduced nodes skip the second landing generation
+  const bool holdAllowed{m_config.allowHold && !reduced &&
+                         !(nodeIndex == 0 && m_rootHoldUsed)};
+  if (holdAllowed && held.has_value()) {
+    if (*held != current) {
+      expandPiece(nodeIndex, *held, current, queueIndex + 1, true,
+                  landingLimit, deadline, candidates);
+    }
+  } else if (holdAllowed && queueIndex + 1 < sequenceSize) {
+    expandPiece(nodeIndex, m_sequence.at(queueIndex + 1), current,
+                queueIndex + 2, true, landingLimit, deadline, candidates);
+  }
+
+  // Drop children far below their best sibling before they reach the sort
+  if (m_config.futilityMargin > 0.0 && !candidates.empty()) {
+    const double bound{
+        std::ranges::max(candidates, {}, &Candidate::score).score -
+        m_config.futilityMargin};
+    std::erase_if(candidates, [bound](const Candidate& candidate) {
+      return candidate.score < bound;
+    });
+  }
+}
+
+void BeamSearch::expandPiece(const uint32_t nodeIndex, const PieceType type,
+                             const std::optional<PieceType> held,
+                             const int32_t queueIndex, const bool useHold,
+                             const size_t landingLimit,
+                             const SearchDeadline& deadline,
+                             std::vector<Candidate>& candidates) {
+  const Node& node{m_arena.at(nodeIndex)};
+  GameState& scratch{
+      m_scratch.at(m_executor ? m_executor->getCurrentSlot() : 0)};
+  const auto rotationSystem{scratch.getRotationSystem()};
+
+  // Make: generate landings on the node's board
+  scratch.getBoard() = node.board;
+  const Piece spawned{rotationSystem->getInitialState(type,
+                                                      node.board.getWidth(),
+                                                      node.board.getHeight()),
+                      rotationSystem};
+  if (!m_movegen->canPlacePiece(scratch, spawned)) {
+    return;
+  }
+  const std::vector<LandingPosition> landings{
+      m_movegen->findLandingPositions(scratch, spawned, 0, deadline)};
+  const uint64_t pieceKey{getPieceKey(queueIndex, held)};
+
+  // Landings come in discovery order; score the promising ones first
+  std::vector<const LandingPosition*> ordered{};
+  ordered.reserve(landings.size());
+  for (const LandingPosition& landing : landings) {
+    ordered.push_back(&landing);
+  }
+  std::ranges::stable_sort(ordered, isOrderedBefore);
+  ordered.resize(std::min(ordered.size(), landingLimit));
+
+  for (const LandingPosition* const orderedLanding : ordered) {
+    const LandingPosition& landing{*orderedLanding};
+    // Place each landing on a copy of the parent and score it
+    Board board{node.board};
+    const PlacementResult placement{
+        placePiece(board, landing.getPiece(), landing.getTSpinType())};
+    BoardFeatures features{node.features};
+    features.update(board, placement);
+
+    const AttackResult attack{m_attackTable.computeAttack(
+        placement, node.combo, node.backToBack)};
+    const double reward{node.reward + m_config.attackWeight * attack.attack};
+
+    Candidate& candidate{candidates.emplace_back()};
+    candidate.piece = landing.getPiece().getState();
+    candidate.tSpinType = landing.getTSpinType();
+    candidate.held = held;
+    candidate.parent = nodeIndex;
+    candidate.queueIndex = queueIndex;
+    candidate.combo = attack.combo;
+    candidate.backToBack = attack.backToBack;
+    candidate.reward = reward;
+    candidate.score =
+        m_evaluator->evaluate(board, features, placement) + reward;
+    candidate.key = board.getZobristKey() ^ pieceKey ^
+                    getComboKey(attack.combo) ^
+                    (attack.backToBack ? zobristBackToBackKey : 0);
+
+    if (nodeIndex == 0) {
+      candidate.rootMove = static_cast<int32_t>(m_rootMoves.size());
+      m_rootMoves.push_back(RootMove{.landing = landing, .useHold = useHold});
+    } else {
+      candidate.rootMove = node.rootMove;
+    }
+  }
+}
+
+void BeamSearch::selectBeam(std::vector<Candidate>& candidates,
+                            std::vector<uint32_t>& beam) {
+  // Best first; ties keep generation order so results are reproducible
+  std::ranges::stable_sort(candidates, std::ranges::greater{},
+                           &Candidate::score);
+
+  beam.clear();
+  const auto rotationSystem{m_scratch.front().getRotationSystem()};
+  for (size_t i{0}; i < candidates.size() && beam.size() < m_config.beamWidth;
+       ++i) {
+    const Candidate& candidate{candidates.at(i)};
+    // The first occurrence of a state is its best one, drop the others
+    if (!m_beamStates.insert(candidate.key).second) {
+      continue;
+    }
+    const Node& parent{m_arena.at(candidate.parent)};
+
+    // Rebuild the child, this time keeping it
+    Node child{parent.board, parent.features};
+    const PlacementResult placement{
+        placePiece(child.board, Piece{candidate.piece, rotationSystem},
+                   candidate.tSpinType)};
+    child.features.update(child.board, placement);
+    child.held = candidate.held;
+    child.parent = candidate.parent;
+    child.rootMove = candidate.rootMove;
+    child.queueIndex = candidate.queueIndex;
+    child.combo = candidate.combo;
+    child.backToBack = candidate.backToBack;
+    child.reward = candidate.reward;
+    child.score = candidate.score;
+
+    beam.push_back(static_cast<uint32_t>(m_arena.size()));
+    m_arena.push_back(std::move(child));
+  }
+}
+
+uint64_t BeamSearch::getPieceKey(const int32_t queueIndex,
+                                 const std::optional<PieceType> held) const {
+  return getQueueKey(std::span{m_sequence}.subspan(
+             static_cast<size_t>(queueIndex))) ^
+         getHoldKey(held);
+}
+
+} // namespace tetris
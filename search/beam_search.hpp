@@ -0,0 +1,325 @@
+#pragma once
+
+#include "../core/attack_table.hpp"
+#include "../core/game_state.hpp"
+#include "../core/placement.hpp"
+#include "../evaluation/board_features.hpp"
+#include "../evaluation/evaluator.hpp"
+#include "search_algorithm.hpp"
+#include "search_deadline.hpp"
+#include "transposition_table.hpp"
+#include "work_stealing_executor.hpp"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tetris {
+
+/**
+ * @class BeamSearch
+ * @brief Multi-piece beam search over the current piece, hold and preview
+ *
+ * Each ply places one piece: the next piece of the sequence, or the piece
+ * obtained by holding. Every child is scored by the evaluator plus the attack
+ * accumulated along its path, and only the best beamWidth states of a ply are
+ * expanded further. The move returned is the first placement on the path to
+ * the best state of the deepest ply.
+ *
+ * All nodes of a search live in one arena that keeps its capacity between
+ * searches. Children are made on a scratch board copied from their parent and
+ * discarded unless they enter the beam, and landing positions are generated on
+ * a single scratch GameState whose board is swapped per node, so no
+ * GameState is cloned per node.
+ *
+ * States reached by several placement orders are kept once per search, leaving
+ * the beam width to distinct states. A state is told apart by its board, the
+ * pieces still to play, the held piece, the combo and the back-to-back chain,
+ * as in GameState::getHash().
+ *
+ * A transposition table keeps the result of every search keyed on the hash of
+ * its root state: the chosen move, its score and the depth it was searched
+ * to. A later search of the same state to at most that depth returns the
+ * stored move once the first ply is generated. Entries do not depend on the
+ * search that wrote them, so any number of searches, on any threads, can share
+ * one table as long as they share the evaluator and configuration.
+ *
+ * With an executor, the nodes of a ply are expanded in parallel. Children are
+ * gathered per node and merged in beam order before the stable sort, so the
+ * chosen move does not depend on the number of threads.
+ *
+ * Landings are ordered statically before they are scored: spins and line
+ * clears first, then the lowest placements. Two pruning policies can trade
+ * accuracy for depth within a deadline. Futility pruning skips beam nodes, and
+ * drops children, that score more than a margin below the best of their ply
+ * or of their siblings. Late-move reduction expands the lower ranked nodes of
+ * the beam without hold and scores only their first landings in static order.
+ */
+class BeamSearch {
+public:
+  /**
+   * @brief Configuration options for beam search
+   */
+  struct Config {
+    size_t beamWidth{64};       ///< States kept per ply
+    size_t depth{3};            ///< Maximum number of plies
+    bool allowHold{true};       ///< Consider holding at every ply
+    double attackWeight{1.0};   ///< Score per line of attack sent
+    double futilityMargin{0.0}; ///< Score gap to the best that prunes, 0 none
+    size_t lateMoveStart{0};    ///< Beam rank of the first reduced node, 0 none
+    size_t lateMoveChildren{8}; ///< Landings scored by a reduced node
+  };
+
+  /**
+   * @brief The placement chosen by a search
+   */
+  struct Result {
+    LandingPosition landing; ///< Landing of the piece to place now
+    bool useHold{false};     ///< Whether to hold before placing
+    double score{0.0};       ///< Score of the best state found
+    size_t depth{0};         ///< Ply of the best state found
+  };
+
+  /**
+   * @brief Construct a beam search with the default configuration
+   *
+   * @param movegen The algorithm generating landing positions
+   * @param evaluator The evaluator scoring placements
+   * @param attackTable The attack rules
+   * @throws std::invalid_argument if movegen or evaluator is null
+   */
+  BeamSearch(std::shared_ptr<const SearchAlgorithm> movegen,
+             std::shared_ptr<const Evaluator> evaluator,
+             const AttackTable& attackTable = AttackTable::guideline());
+
+  /**
+   * @brief Construct a beam search
+   *
+   * @param movegen The algorithm generating landing positions
+   * @param evaluator The evaluator scoring placements
+   * @param attackTable The attack rules
+   * @param config The search configuration
+   * @throws std::invalid_argument if movegen or evaluator is null
+   */
+  BeamSearch(std::shared_ptr<const SearchAlgorithm> movegen,
+             std::shared_ptr<const Evaluator> evaluator,
+             const AttackTable& attackTable, const Config& config);
+
+  /**
+   * @brief Search for the best placement of the current piece
+   *
+   * The current piece of the state must have been spawned.
+   *
+   * @param gameState The current game state
+   * @return The chosen placement, or std::nullopt if no piece can be placed
+   */
+  [[nodiscard]] std::optional<Result> search(const GameState& gameState);
+
+  /**
+   * @brief Search for the best placement until a deadline
+   *
+   * Plies are searched one after the other, each one deepening the previous
+   * result. When the deadline expires during a ply, that ply is discarded and
+   * the best state of the last complete ply decides the move. The first ply
+   * always completes, so a move is returned whenever one exists.
+   *
+   * @param gameState The current game state
+   * @param deadline The deadline of the search
+   * @return The chosen placement, or std::nullopt if no piece can be placed
+   */
+  [[nodiscard]] std::optional<Result> search(const GameState& gameState,
+                                             const SearchDeadline& deadline);
+
+  /**
+   * @brief Get the configuration options
+   */
+  [[nodiscard]] const Config& getConfig() const { return m_config; }
+
+  /**
+   * @brief Set the configuration options
+   */
+  void setConfig(const Config& config) { m_config = config; }
+
+  /**
+   * @brief Get the transposition table, null if none is used
+   */
+  [[nodiscard]] const std::shared_ptr<TranspositionTable>&
+  getTranspositionTable() const {
+    return m_table;
+  }
+
+  /**
+   * @brief Set the transposition table storing the results of searches
+   *
+   * @param table The table, or null to search every state again
+   */
+  void setTranspositionTable(std::shared_ptr<TranspositionTable> table) {
+    m_table = std::move(table);
+  }
+
+  /**
+   * @brief Get the executor expanding nodes in parallel, null if none is used
+   */
+  [[nodiscard]] const std::shared_ptr<WorkStealingExecutor>&
+  getExecutor() const {
+    return m_executor;
+  }
+
+  /**
+   * @brief Set the executor expanding nodes in parallel
+   *
+   * @param executor The executor, or null to expand on the calling thread
+   */
+  void setExecutor(std::shared_ptr<WorkStealingExecutor> executor) {
+    m_executor = std::move(executor);
+  }
+
+  /**
+   * @brief Get the number of nodes expanded by the last search
+   */
+  [[nodiscard]] size_t getExpandedNodeCount() const {
+    return m_expandedNodeCount;
+  }
+
+  /**
+   * @brief Get the number of beam nodes skipped by futility pruning in the
+   * last search
+   */
+  [[nodiscard]] size_t getPrunedNodeCount() const { return m_prunedNodeCount; }
+
+private:
+  /**
+   * @brief A state kept in the beam
+   */
+  struct Node {
+    /**
+     * @brief Construct a node holding a board and its features
+     */
+    Node(const Board& nodeBoard, const BoardFeatures& nodeFeatures)
+        : board{nodeBoard}, features{nodeFeatures} {}
+
+    Board board;                   ///< Board after the placement
+    BoardFeatures features;        ///< Features of the board
+    std::optional<PieceType> held; ///< Held piece after the placement
+    uint32_t parent{0};            ///< Arena index of the parent
+    int32_t rootMove{-1};          ///< Index of the first placement
+    int32_t queueIndex{0};         ///< Sequence index of the next piece
+    int32_t combo{0};              ///< Combo after the placement
+    bool backToBack{false};        ///< Back-to-back state after it
+    double reward{0.0};            ///< Attack reward along the path
+    double score{0.0};             ///< Evaluation plus reward
+  };
+
+  /**
+   * @brief A scored child not yet materialized in the arena
+   */
+  struct Candidate {
+    PieceState piece;              ///< Landing of the placed piece
+    int32_t tSpinType{0};          ///< T-spin type of the landing
+    std::optional<PieceType> held; ///< Held piece after the placement
+    uint32_t parent{0};            ///< Arena index of the parent
+    int32_t rootMove{-1};          ///< Index of the first placement
+    int32_t queueIndex{0};         ///< Sequence index of the next piece
+    int32_t combo{0};              ///< Combo after the placement
+    bool backToBack{false};        ///< Back-to-back state after it
+    double reward{0.0};            ///< Attack reward along the path
+    double score{0.0};             ///< Evaluation plus reward
+    uint64_t key{0};               ///< Hash of the state after it
+  };
+
+  /**
+   * @brief A placement option of the first ply
+   */
+  struct RootMove {
+    LandingPosition landing; ///< Landing of the piece
+    bool useHold{false};     ///< Whether the piece comes from hold
+  };
+
+  /**
+   * @brief Generate and score the children of every node of the beam
+   *
+   * @param beam Arena indices of the nodes
+   * @param deadline The deadline, copied for every node
+   * @param candidates Output, the children in beam order
+   */
+  void expandBeam(const std::vector<uint32_t>& beam,
+                  const SearchDeadline& deadline,
+                  std::vector<Candidate>& candidates);
+
+  /**
+   * @brief Generate and score the children of a node
+   *
+   * May run on any thread of the executor.
+   *
+   * @param nodeIndex Arena index of the node
+   * @param reduced Whether the node gets a late-move reduced expansion
+   * @param deadline The deadline of the landing generation
+   * @param candidates Output, the children of the node
+   */
+  void expand(uint32_t nodeIndex, bool reduced, const SearchDeadline& deadline,
+              std::vector<Candidate>& candidates);
+
+  /**
+   * @brief Generate and score the children placing one piece type
+   *
+   * @param nodeIndex Arena index of the node
+   * @param type The piece to place
+   * @param held The held piece after the placement
+   * @param queueIndex The sequence index of the next piece afterwards
+   * @param useHold Whether the piece comes from hold
+   * @param landingLimit The number of landings to score in static order
+   * @param deadline The deadline of the landing generation
+   * @param candidates Output, children are appended
+   */
+  void expandPiece(uint32_t nodeIndex, PieceType type,
+                   std::optional<PieceType> held, int32_t queueIndex,
+                   bool useHold, size_t landingLimit,
+                   const SearchDeadline& deadline,
+                   std::vector<Candidate>& candidates);
+
+  /**
+   * @brief Keep the best candidates and add them to the arena
+   *
+   * Candidates whose state is already in the beam are skipped.
+   *
+   * @param candidates The scored children of the current ply
+   * @param beam Output, arena indices of the new beam
+   */
+  void selectBeam(std::vector<Candidate>& candidates,
+                  std::vector<uint32_t>& beam);
+
+  /**
+   * @brief Get the hash of the pieces still to play and the held piece
+   *
+   * Children spawn a new piece, so hold is never used in them.
+   *
+   * @param queueIndex The sequence index of the next piece
+   * @param held The held piece
+   * @return The hash to combine with the board key
+   */
+  [[nodiscard]] uint64_t getPieceKey(int32_t queueIndex,
+                                     std::optional<PieceType> held) const;
+
+  std::shared_ptr<const SearchAlgorithm> m_movegen; ///< Landing generator
+  std::shared_ptr<const Evaluator> m_evaluator;     ///< Placement evaluator
+  AttackTable m_attackTable;                        ///< Attack rules
+  Config m_config;                                  ///< Search configuration
+  std::shared_ptr<TranspositionTable> m_table;      ///< Transposition table
+  std::shared_ptr<WorkStealingExecutor> m_executor; ///< Parallel expansion
+
+  std::vector<GameState> m_scratch;   ///< Landing generation state per slot
+  std::vector<Node> m_arena;          ///< Storage of every beam node
+  std::vector<std::vector<Candidate>>
+      m_nodeCandidates;               ///< Children of each node of the ply
+  std::vector<PieceType> m_sequence;  ///< Current piece followed by preview
+  std::vector<RootMove> m_rootMoves;  ///< Placement options of the first ply
+  std::unordered_set<uint64_t>
+      m_beamStates;                   ///< Hashes of the states of the beam
+  bool m_rootHoldUsed{false};         ///< Whether hold is locked at the root
+  size_t m_expandedNodeCount{0};      ///< Nodes expanded by the last search
+  size_t m_prunedNodeCount{0};        ///< Nodes skipped by the last search
+};
+
+} // namespace tetris
@@ -0,0 +1,656 @@
+#include "monte_carlo_tree_search.hpp"
+#include "../core/zobrist.hpp"
+#include "../evaluation/board_features.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+namespace tetris {
+
+namespace {
+
+/**
+ * @brief Value of a node where the next piece cannot be placed
+ */
+constexpr double toppedOutValue{-1.0e9};
+
+} // namespace
+
+MonteCarloTreeSearch::MonteCarloTreeSearch(
+    std::shared_ptr<const SearchAlgorithm> movegen,
+    std::shared_ptr<const Evaluator> evaluator, const AttackTable& attackTable)
+    : MonteCarloTreeSearch{std::move(movegen), std::move(evaluator),
+                           attackTable, Config{}} {}
+
+MonteCarloTreeSearch::MonteCarloTreeSearch(
+    std::shared_ptr<const SearchAlgorithm> movegen,
+    std::shared_ptr<const Evaluator> evaluator, const AttackTable& attackTable,
+    const Config& config)
+    : m_movegen{std::move(movegen)}, m_evaluator{std::move(evaluator)},
+      m_attackTable{attackTable}, m_config{config} {
+  [[unlikely]] if (!m_movegen || !m_evaluator) {
+    throw std::invalid_argument("Move generator and evaluator cannot be null");
+  }
+}
+
+void MonteCarloTreeSearch::reset(const GameState& gameState) {
+  m_nodes.clear();
+  m_edges.clear();
+  m_nodeIndex.clear();
+  m_freeNodes.clear();
+  m_freeEdgeBlocks.clear();
+  m_landingCache.clear();
+  m_root = 0;
+  m_rootState.reset();
+  m_scratch.reset();
+  if (gameState.isGameOver() || !gameState.getRotationSystem()) {
+    return;
+  }
+
+  // The piece sequence is the current piece followed by the preview
+  m_sequence.clear();
+  m_sequence.push_back(gameState.getCurrentPiece().getState().getType());
+  m_sequence.insert(m_sequence.end(), gameState.getNextPieces().begin(),
+                    gameState.getNextPieces().end());
+  m_horizonBag = BagState::fromSequence(m_sequence);
+  m_rootHoldUsed = gameState.isHoldUsed();
+  m_rootState = gameState.clone();
+  m_scratch = gameState.clone();
+
+  Node& root{m_nodes.emplace_back(gameState.getBoard())};
+  root.held = gameState.getHeldPiece();
+  root.combo = gameState.getCombo();
+  root.backToBack = gameState.isBackToBack();
+  m_nodeIndex.emplace(getNodeKey(root), m_root);
+}
+
+size_t MonteCarloTreeSearch::run(const size_t iterations) {
+  return run(SearchDeadline{}, iterations);
+}
+
+size_t MonteCarloTreeSearch::run(const SearchDeadline& deadline,
+                                 const size_t iterations) {
+  if (m_nodes.empty()) {
+    return 0;
+  }
+
+  // Iterations cost whole landing generations, so read the clock every time
+  const SearchDeadline unlimited{};
+  size_t iteration{0};
+  for (; iteration < iterations; ++iteration) {
+    if (m_nodes.at(m_root).exhausted || getNodeCount() >= m_config.maxNodes) {
+      break;
+    }
+    if (m_nodes.at(m_root).expanded && deadline.checkNow()) {
+      break;
+    }
+
+    // Selection: descend through expanded nodes, stopping at one whose hold
+    // branch can be added
+    m_path.clear();
+    uint32_t nodeIndex{m_root};
+    m_path.push_back(nodeIndex);
+    while (m_nodes.at(nodeIndex).expanded &&
+           !canExpandHold(m_nodes.at(nodeIndex))) {
+      const uint32_t edgeIndex{select(nodeIndex)};
+      if (edgeIndex == noIndex) {
+        break;
+      }
+      nodeIndex = m_edges.at(edgeIndex).child;
+      m_path.push_back(nodeIndex);
+    }
+
+    // Expansion: generate and evaluate the children of the leaf
+    const SearchDeadline& expansionDeadline{nodeIndex == m_root ? unlimited
+                                                                : deadline};
+    if (!m_nodes.at(nodeIndex).expanded) {
+      if (!expand(nodeIndex, expansionDeadline)) {
+        break;
+      }
+    } else if (canExpandHold(m_nodes.at(nodeIndex)) &&
+               !expandHold(nodeIndex, expansionDeadline)) {
+      break;
+    }
+
+    // Backup: best values propagate from the leaf to the root
+    for (const uint32_t pathIndex : std::views::reverse(m_path)) {
+      ++m_nodes.at(pathIndex).visits;
+      backup(pathIndex);
+    }
+  }
+  return iteration;
+}
+
+bool MonteCarloTreeSearch::advance(const PieceState& piece,
+                                   const bool useHold) {
+  if (m_nodes.empty()) {
+    return false;
+  }
+
+  const Node& root{m_nodes.at(m_root)};
+  const auto rootEdges{getEdges(root)};
+  const auto edge{std::ranges::find_if(rootEdges, [&](const Edge& candidate) {
+    return candidate.piece == piece && candidate.useHold == useHold;
+  })};
+  if (edge == rootEdges.end()) {
+    return false;
+  }
+
+  // Discard the old root and every node only reachable through it. The new
+  // root holds a reference of its own so merges into discarded siblings do
+  // not free it.
+  const uint32_t newRoot{edge->child};
+  ++m_nodes.at(newRoot).parentCount;
+  release(m_root);
+  --m_nodes.at(newRoot).parentCount;
+  m_root = newRoot;
+
+  // The placed piece has locked, so hold is available again
+  const Node& placed{m_nodes.at(m_root)};
+  m_rootHoldUsed = false;
+  m_rootState->getBoard() = placed.board;
+  m_rootState->setHeldPiece(placed.held);
+  m_rootState->setHoldUsed(false);
+  return true;
+}
+
+bool MonteCarloTreeSearch::sync(const GameState& gameState) {
+  if (m_nodes.empty() || gameState.isGameOver()) {
+    return false;
+  }
+
+  const Node& root{m_nodes.at(m_root)};
+  if (root.board != gameState.getBoard() ||
+      root.held != gameState.getHeldPiece() ||
+      m_rootHoldUsed != gameState.isHoldUsed() ||
+      root.combo != gameState.getCombo() ||
+      root.backToBack != gameState.isBackToBack()) {
+    return false;
+  }
+
+  // The pieces the tree knows must start the actual queue
+  std::vector<PieceType> queue{gameState.getCurrentPiece().getState().getType()};
+  queue.insert(queue.end(), gameState.getNextPieces().begin(),
+               gameState.getNextPieces().end());
+  const auto known{
+      std::span{m_sequence}.subspan(static_cast<size_t>(root.queueIndex))};
+  if (queue.size() < known.size() ||
+      !std::ranges::equal(known, std::span{queue}.first(known.size()))) {
+    return false;
+  }
+
+  const auto horizon{static_cast<int32_t>(m_sequence.size())};
+  m_sequence.insert(m_sequence.end(),
+                    queue.begin() + static_cast<std::ptrdiff_t>(known.size()),
+                    queue.end());
+  m_horizonBag = BagState::fromSequence(m_sequence);
+  m_rootState = gameState.clone();
+
+  // Lines that stopped at the old horizon can grow again, and so can hold
+  // branches that needed the piece after it. Exhausted flags are recomputed
+  // by the next backups; only topped out nodes stay closed.
+  if (static_cast<int32_t>(m_sequence.size()) > horizon) {
+    for (Node& node : m_nodes) {
+      const bool leaf{node.expanded && node.edgeCount == 0};
+      if (leaf && node.queueIndex >= horizon) {
+        node.expanded = false;
+      }
+      if (!leaf || node.queueIndex >= horizon || canExpandHold(node)) {
+        node.exhausted = false;
+      }
+    }
+  }
+  return true;
+}
+
+std::optional<MonteCarloTreeSearch::Result>
+MonteCarloTreeSearch::getBestMove() const {
+  if (m_nodes.empty() || m_nodes.at(m_root).edgeCount == 0) {
+    return std::nullopt;
+  }
+
+  // Highest reward plus value; the first edge wins ties
+  const Node& root{m_nodes.at(m_root)};
+  const auto edges{getEdges(root)};
+  const Edge* best{nullptr};
+  double bestValue{-std::numeric_limits<double>::infinity()};
+  for (const Edge& edge : edges) {
+    const double value{edge.reward + m_nodes.at(edge.child).value};
+    if (value > bestValue) {
+      bestValue = value;
+      best = &edge;
+    }
+  }
+
+  // Rebuild the landing with the moves that reach it from spawn
+  const GameState& rootState{*m_rootState};
+  const auto rotationSystem{rootState.getRotationSystem()};
+  const PieceType type{best->piece.getType()};
+  const Board& board{rootState.getBoard()};
+  const Piece spawned{rotationSystem->getInitialState(type, board.getWidth(),
+                                                      board.getHeight()),
+                      rotationSystem};
+  LandingPosition landing{Piece{best->piece, rotationSystem}};
+  landing.setTSpinType(best->tSpinType);
+  landing.setLinesCleared(countClearedLines(board, landing.getPiece()));
+  landing.setPath(m_movegen->findPath(rootState, spawned, landing.getPiece()));
+
+  return Result{.landing = std::move(landing),
+                .useHold = best->useHold,
+                .value = bestValue,
+                .visits = m_nodes.at(best->child).visits};
+}
+
+std::optional<MonteCarloTreeSearch::Result>
+MonteCarloTreeSearch::search(const GameState& gameState,
+                             const size_t iterations) {
+  reset(gameState);
+  run(iterations);
+  return getBestMove();
+}
+
+std::optional<MonteCarloTreeSearch::Result>
+MonteCarloTreeSearch::search(const GameState& gameState,
+                             const SearchDeadline& deadline) {
+  reset(gameState);
+  run(deadline);
+  return getBestMove();
+}
+
+bool MonteCarloTreeSearch::expand(const uint32_t nodeIndex,
+                                  const SearchDeadline& deadline) {
+  const int32_t queueIndex{m_nodes.at(nodeIndex).queueIndex};
+  const std::optional<PieceType> held{m_nodes.at(nodeIndex).held};
+  const auto sequenceSize{static_cast<int32_t>(m_sequence.size())};
+  const size_t edgeCount{m_edges.size()};
+  m_newNodes.clear();
+  m_nodes.at(nodeIndex).expanded = true;
+  m_nodes.at(nodeIndex).firstEdge = static_cast<uint32_t>(edgeCount);
+
+  // Lines past the known pieces end here, valued by the next piece the bag
+  // may deal or by their evaluation
+  if (queueIndex >= sequenceSize) {
+    if (m_config.bagExpectation) {
+      const std::optional<double> expectation{
+          getBagExpectation(nodeIndex, deadline)};
+      if (!expectation.has_value()) {
+        m_nodes.at(nodeIndex).expanded = false;
+        m_nodes.at(nodeIndex).firstEdge = noIndex;
+        return false;
+      }
+      m_nodes.at(nodeIndex).value = *expectation;
+    }
+    m_nodes.at(nodeIndex).exhausted = true;
+    return true;
+  }
+
+  // Place the next piece of the sequence
+  const PieceType current{m_sequence.at(queueIndex)};
+  expandPiece(nodeIndex, current, held, queueIndex + 1, false, deadline);
+
+  // Hold it and place the held piece, or the one after it if hold is empty;
+  // that one may only be revealed by a later sync()
+  const bool holdAllowed{m_config.allowHold &&
+                         !(nodeIndex == m_root && m_rootHoldUsed)};
+  bool holdPending{false};
+  if (holdAllowed) {
+    if (held.has_value()) {
+      if (*held != current) {
+        expandPiece(nodeIndex, *held, current, queueIndex + 1, true,
+                    deadline);
+      }
+    } else if (queueIndex + 1 < sequenceSize) {
+      expandPiece(nodeIndex, m_sequence.at(queueIndex + 1), current,
+                  queueIndex + 2, true, deadline);
+    } else {
+      holdPending = true;
+    }
+  }
+
+  // Landing lists cut short by the deadline would look like a complete set of
+  // children, so undo the expansion and its new nodes instead
+  if (deadline.checkNow()) {
+    undoExpansion(edgeCount);
+    m_nodes.at(nodeIndex).expanded = false;
+    m_nodes.at(nodeIndex).firstEdge = noIndex;
+    return false;
+  }
+
+  m_nodes.at(nodeIndex).holdPending = holdPending;
+  placeEdges(nodeIndex, edgeCount);
+  return true;
+}
+
+bool MonteCarloTreeSearch::expandHold(const uint32_t nodeIndex,
+                                      const SearchDeadline& deadline) {
+  const int32_t queueIndex{m_nodes.at(nodeIndex).queueIndex};
+  const uint32_t firstEdge{m_nodes.at(nodeIndex).firstEdge};
+  const uint32_t oldEdgeCount{m_nodes.at(nodeIndex).edgeCount};
+  const size_t edgeCount{m_edges.size()};
+  m_newNodes.clear();
+
+  // The children must stay contiguous, so the existing ones are copied to the
+  // end of the arena and the hold branch follows them
+  for (uint32_t i{0}; i < oldEdgeCount; ++i) {
+    const Edge edge{m_edges.at(firstEdge + i)};
+    m_edges.push_back(edge);
+  }
+  expandPiece(nodeIndex, m_sequence.at(queueIndex + 1),
+              m_sequence.at(queueIndex), queueIndex + 2, true, deadline);
+
+  if (deadline.checkNow()) {
+    // The copies hold no references of their own
+    undoExpansion(edgeCount + oldEdgeCount);
+    m_edges.resize(edgeCount);
+    return false;
+  }
+
+  if (oldEdgeCount > 0) {
+    if (oldEdgeCount >= m_freeEdgeBlocks.size()) {
+      m_freeEdgeBlocks.resize(oldEdgeCount + 1);
+    }
+    m_freeEdgeBlocks.at(oldEdgeCount).push_back(firstEdge);
+  }
+  m_nodes.at(nodeIndex).holdPending = false;
+  m_nodes.at(nodeIndex).firstEdge = static_cast<uint32_t>(edgeCount);
+  placeEdges(nodeIndex, edgeCount);
+  return true;
+}
+
+void MonteCarloTreeSearch::undoExpansion(const size_t edgeCount) {
+  for (const Edge& edge : std::span{m_edges}.subspan(edgeCount)) {
+    --m_nodes.at(edge.child).parentCount;
+  }
+  for (const uint32_t newNode : m_newNodes) {
+    m_nodeIndex.erase(getNodeKey(m_nodes.at(newNode)));
+    m_freeNodes.push_back(newNode);
+  }
+  m_edges.erase(m_edges.begin() + static_cast<std::ptrdiff_t>(edgeCount),
+                m_edges.end());
+}
+
+void MonteCarloTreeSearch::placeEdges(const uint32_t nodeIndex,
+                                      const size_t edgeCount) {
+  Node& node{m_nodes.at(nodeIndex)};
+  node.edgeCount = static_cast<uint32_t>(m_edges.size() - edgeCount);
+  if (node.edgeCount == 0) {
+    node.firstEdge = noIndex;
+    node.value = toppedOutValue;
+    node.exhausted = !canExpandHold(node);
+    return;
+  }
+
+  // Move the children into a discarded block of the same length, if any
+  if (node.edgeCount < m_freeEdgeBlocks.size() &&
+      !m_freeEdgeBlocks.at(node.edgeCount).empty()) {
+    std::vector<uint32_t>& blocks{m_freeEdgeBlocks.at(node.edgeCount)};
+    const uint32_t block{blocks.back()};
+    blocks.pop_back();
+    std::ranges::copy(std::span{m_edges}.subspan(edgeCount),
+                      m_edges.begin() + block);
+    m_edges.resize(edgeCount);
+    node.firstEdge = block;
+  }
+}
+
+const std::vector<LandingPosition>*
+MonteCarloTreeSearch::getLandings(const Board& board, const PieceType type,
+                                  const SearchDeadline& deadline) {
+  const uint64_t key{board.getZobristKey() ^ getQueueKey(0, type)};
+  if (const auto entry{m_landingCache.find(key)};
+      entry != m_landingCache.end()) {
+    return &entry->second;
+  }
+
+  GameState& scratch{*m_scratch};
+  const auto rotationSystem{scratch.getRotationSystem()};
+  scratch.getBoard() = board;
+  const Piece spawned{rotationSystem->getInitialState(type, board.getWidth(),
+                                                      board.getHeight()),
+                      rotationSystem};
+  std::vector<LandingPosition> landings{};
+  if (m_movegen->canPlacePiece(scratch, spawned)) {
+    landings = m_movegen->findLandingPositions(scratch, spawned, 0, deadline);
+  }
+
+  // A list cut short by the deadline must not be reused as complete
+  if (deadline.checkNow()) {
+    return nullptr;
+  }
+  if (m_landingCache.size() >= m_config.maxNodes) {
+    m_landingCache.clear();
+  }
+  return &m_landingCache.emplace(key, std::move(landings)).first->second;
+}
+
+std::optional<double>
+MonteCarloTreeSearch::getBagExpectation(const uint32_t nodeIndex,
+                                        const SearchDeadline& deadline) {
+  const Node& node{m_nodes.at(nodeIndex)};
+  const BoardFeatures features{node.board};
+
+  const auto getBestValue{[&](const PieceType type) -> std::optional<double> {
+    const std::vector<LandingPosition>* landings{
+        getLandings(node.board, type, deadline)};
+    if (landings == nullptr) {
+      return std::nullopt;
+    }
+
+    double best{toppedOutValue};
+    for (const LandingPosition& landing : *landings) {
+      Board board{node.board};
+      const PlacementResult placement{
+          placePiece(board, landing.getPiece(), landing.getTSpinType())};
+      const AttackResult attack{
+          m_attackTable.computeAttack(placement, node.combo, node.backToBack)};
+      BoardFeatures placed{features};
+      placed.update(board, placement);
+      best = std::max(best, m_config.attackWeight * attack.attack +
+                                m_evaluator->evaluate(board, placed,
+                                                      placement));
+    }
+    return best;
+  }};
+
+  // Every piece left in the bag is equally likely to come next; it can be
+  // placed or swapped for the held piece
+  const std::vector<PieceType> pieces{m_horizonBag.getRemainingPieces()};
+  double total{0.0};
+  for (const PieceType type : pieces) {
+    std::optional<double> value{getBestValue(type)};
+    if (value.has_value() && m_config.allowHold && node.held.has_value() &&
+        *node.held != type) {
+      const std::optional<double> heldValue{getBestValue(*node.held)};
+      value = heldValue.has_value()
+                  ? std::optional<double>{std::max(*value, *heldValue)}
+                  : std::nullopt;
+    }
+    if (!value.has_value()) {
+      return std::nullopt;
+    }
+    total += *value;
+  }
+  return total / static_cast<double>(pieces.size());
+}
+
+uint32_t MonteCarloTreeSearch::allocateNode(Node&& node) {
+  if (m_freeNodes.empty()) {
+    m_nodes.push_back(std::move(node));
+    return static_cast<uint32_t>(m_nodes.size() - 1);
+  }
+
+  const uint32_t index{m_freeNodes.back()};
+  m_freeNodes.pop_back();
+  m_nodes.at(index) = std::move(node);
+  return index;
+}
+
+void MonteCarloTreeSearch::release(const uint32_t nodeIndex) {
+  // Children are released when their last parent is, nodes still reachable
+  // from elsewhere keep their references and are never visited
+  std::vector<uint32_t> pending{nodeIndex};
+  while (!pending.empty()) {
+    const uint32_t index{pending.back()};
+    pending.pop_back();
+
+    Node& node{m_nodes.at(index)};
+    if (node.edgeCount > 0) {
+      for (const Edge& edge : getEdges(node)) {
+        if (--m_nodes.at(edge.child).parentCount == 0) {
+          pending.push_back(edge.child);
+        }
+      }
+      if (node.edgeCount >= m_freeEdgeBlocks.size()) {
+        m_freeEdgeBlocks.resize(node.edgeCount + 1);
+      }
+      m_freeEdgeBlocks.at(node.edgeCount).push_back(node.firstEdge);
+    }
+
+    const auto entry{m_nodeIndex.find(getNodeKey(node))};
+    if (entry != m_nodeIndex.end() && entry->second == index) {
+      m_nodeIndex.erase(entry);
+    }
+    node.expanded = false;
+    node.exhausted = true;
+    node.firstEdge = noIndex;
+    node.edgeCount = 0;
+    m_freeNodes.push_back(index);
+  }
+}
+
+void MonteCarloTreeSearch::expandPiece(const uint32_t nodeIndex,
+                                       const PieceType type,
+                                       const std::optional<PieceType> held,
+                                       const int32_t queueIndex,
+                                       const bool useHold,
+                                       const SearchDeadline& deadline) {
+  // Copy what is needed of the parent, the node arena grows below
+  const Board parentBoard{m_nodes.at(nodeIndex).board};
+  const int32_t parentCombo{m_nodes.at(nodeIndex).combo};
+  const bool parentBackToBack{m_nodes.at(nodeIndex).backToBack};
+
+  const std::vector<LandingPosition>* landings{
+      getLandings(parentBoard, type, deadline)};
+  if (landings == nullptr) {
+    return;
+  }
+  const BoardFeatures parentFeatures{parentBoard};
+
+  for (const LandingPosition& landing : *landings) {
+    Node child{parentBoard};
+    const PlacementResult placement{
+        placePiece(child.board, landing.getPiece(), landing.getTSpinType())};
+    const AttackResult attack{
+        m_attackTable.computeAttack(placement, parentCombo, parentBackToBack)};
+    child.held = held;
+    child.queueIndex = queueIndex;
+    child.combo = attack.combo;
+    child.backToBack = attack.backToBack;
+
+    // Merge transpositions into one node, evaluating new states only
+    const uint64_t key{getNodeKey(child)};
+    const auto entry{m_nodeIndex.find(key)};
+    uint32_t childIndex{};
+    if (entry != m_nodeIndex.end()) {
+      childIndex = entry->second;
+    } else {
+      BoardFeatures features{parentFeatures};
+      features.update(child.board, placement);
+      child.value = m_evaluator->evaluate(child.board, features, placement);
+      childIndex = allocateNode(std::move(child));
+      m_nodeIndex.emplace(key, childIndex);
+      m_newNodes.push_back(childIndex);
+    }
+    ++m_nodes.at(childIndex).parentCount;
+
+    m_edges.push_back(
+        Edge{.piece = landing.getPiece().getState(),
+             .tSpinType = landing.getTSpinType(),
+             .useHold = useHold,
+             .child = childIndex,
+             .reward = m_config.attackWeight * attack.attack});
+  }
+}
+
+uint32_t MonteCarloTreeSearch::select(const uint32_t nodeIndex) const {
+  const Node& node{m_nodes.at(nodeIndex)};
+  const auto edges{getEdges(node)};
+
+  // Normalize values among the open children so the exploration constant
+  // does not depend on the evaluator's scale
+  double lowest{std::numeric_limits<double>::infinity()};
+  double highest{-std::numeric_limits<double>::infinity()};
+  for (const Edge& edge : edges) {
+    const Node& child{m_nodes.at(edge.child)};
+    if (!child.exhausted) {
+      lowest = std::min(lowest, edge.reward + child.value);
+      highest = std::max(highest, edge.reward + child.value);
+    }
+  }
+  const double range{highest > lowest ? highest - lowest : 1.0};
+  const double logVisits{std::log(static_cast<double>(node.visits) + 1.0)};
+
+  uint32_t best{noIndex};
+  double bestScore{-std::numeric_limits<double>::infinity()};
+  for (uint32_t i{0}; i < node.edgeCount; ++i) {
+    const Edge& edge{edges[i]};
+    const Node& child{m_nodes.at(edge.child)};
+    if (child.exhausted) {
+      continue;
+    }
+    const double exploitation{(edge.reward + child.value - lowest) / range};
+    const double exploration{
+        m_config.explorationConstant *
+        std::sqrt(logVisits / (static_cast<double>(child.visits) + 1.0))};
+    if (exploitation + exploration > bestScore) {
+      bestScore = exploitation + exploration;
+      best = node.firstEdge + i;
+    }
+  }
+  return best;
+}
+
+void MonteCarloTreeSearch::backup(const uint32_t nodeIndex) {
+  Node& node{m_nodes.at(nodeIndex)};
+  if (node.edgeCount == 0) {
+    return;
+  }
+
+  double value{-std::numeric_limits<double>::infinity()};
+  bool exhausted{!canExpandHold(node)};
+  for (const Edge& edge : getEdges(node)) {
+    const Node& child{m_nodes.at(edge.child)};
+    value = std::max(value, edge.reward + child.value);
+    exhausted = exhausted && child.exhausted;
+  }
+  node.value = value;
+  node.exhausted = exhausted;
+}
+
+std::span<const MonteCarloTreeSearch::Edge>
+MonteCarloTreeSearch::getEdges(const Node& node) const {
+  if (node.edgeCount == 0) {
+    return {};
+  }
+  return std::span{m_edges}.subspan(node.firstEdge, node.edgeCount);
+}
+
+uint64_t MonteCarloTreeSearch::getNodeKey(const Node& node) const {
+  // The sequence only grows at its end, so the index of the next piece
+  // identifies the pieces to come and keeps keys stable across sync()
+  uint64_t queueState{static_cast<uint64_t>(node.queueIndex)};
+  uint64_t key{node.board.getZobristKey() ^ splitMix64(queueState)};
+  key ^= getHoldKey(node.held);
+  key ^= getComboKey(node.combo);
+  if (node.backToBack) {
+    key ^= zobristBackToBackKey;
+  }
+  return key;
+}
+
+} // namespace tetris
@@ -0,0 +1,397 @@
+#pragma once
+
+#include "../core/attack_table.hpp"
+#include "../core/bag_state.hpp"
+#include "../core/game_state.hpp"
+#include "../core/placement.hpp"
+#include "../evaluation/evaluator.hpp"
+#include "search_algorithm.hpp"
+#include "search_deadline.hpp"
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace tetris {
+
+/**
+ * @class MonteCarloTreeSearch
+ * @brief Tree search over placements that improves the longer it runs
+ *
+ * Nodes are the states after a placement and edges are the landing positions
+ * of the next piece, or of the piece obtained by holding. A node's value
+ * starts as the evaluator score of its placement and is replaced by the best
+ * edge reward plus child value once it has been expanded, so values back up
+ * the best line found below each node. Selection descends with UCT over those
+ * attack-weighted values, normalized among siblings, until it reaches an
+ * unexpanded node.
+ *
+ * Lines that use up the known pieces end in a leaf valued by the expected best
+ * placement of the next piece, averaged over the pieces a 7-bag randomizer
+ * can still deal. Landing lists are cached by board and piece, so branches
+ * reaching the same board share their landing generation.
+ *
+ * Nodes and edges live in two arenas linked by index. Nodes are merged by the
+ * hash of their board, remaining pieces, hold and combo state, so placement
+ * orders that reach the same state share one node and the tree is a DAG.
+ *
+ * Between pieces the tree can be moved to the placed child with advance() and
+ * extended with newly revealed pieces with sync(), so work done before a piece
+ * arrives is not lost. Nodes count the edges leading to them; discarded nodes
+ * and edge blocks go to free lists and are reused by later expansions, so
+ * moving the root costs time in the discarded part of the tree only.
+ */
+class MonteCarloTreeSearch {
+public:
+  /**
+   * @brief Configuration options for the tree search
+   */
+  struct Config {
+    double explorationConstant{1.0};   ///< Weight of UCT exploration
+    double attackWeight{1.0};          ///< Score per line of attack sent
+    bool allowHold{true};              ///< Consider holding at every node
+    bool bagExpectation{true};         ///< Value leaves by the bag's pieces
+    size_t maxNodes{size_t{1} << 18U}; ///< Nodes after which growth stops
+  };
+
+  /**
+   * @brief The placement chosen by a search
+   */
+  struct Result {
+    LandingPosition landing; ///< Landing of the piece to place now
+    bool useHold{false};     ///< Whether to hold before placing
+    double value{0.0};       ///< Reward plus value of the best line
+    uint32_t visits{0};      ///< Visits of the chosen child
+  };
+
+  /**
+   * @brief Construct a tree search with the default configuration
+   *
+   * @param movegen The algorithm generating landing positions
+   * @param evaluator The evaluator scoring placements
+   * @param attackTable The attack rules
+   * @throws std::invalid_argument if movegen or evaluator is null
+   */
+  MonteCarloTreeSearch(
+      std::shared_ptr<const SearchAlgorithm> movegen,
+      std::shared_ptr<const Evaluator> evaluator,
+      const AttackTable& attackTable = AttackTable::guideline());
+
+  /**
+   * @brief Construct a tree search
+   *
+   * @param movegen The algorithm generating landing positions
+   * @param evaluator The evaluator scoring placements
+   * @param attackTable The attack rules
+   * @param config The search configuration
+   * @throws std::invalid_argument if movegen or evaluator is null
+   */
+  MonteCarloTreeSearch(std::shared_ptr<const SearchAlgorithm> movegen,
+                       std::shared_ptr<const Evaluator> evaluator,
+                       const AttackTable& attackTable, const Config& config);
+
+  /**
+   * @brief Discard the tree and start a new one from a state
+   *
+   * The current piece of the state must have been spawned.
+   *
+   * @param gameState The state to search from
+   */
+  void reset(const GameState& gameState);
+
+  /**
+   * @brief Grow the tree
+   *
+   * Stops early once every line has been searched to the end of the known
+   * pieces or the node limit is reached.
+   *
+   * @param iterations The maximum number of iterations
+   * @return The number of iterations run
+   */
+  size_t run(size_t iterations);
+
+  /**
+   * @brief Grow the tree until a deadline
+   *
+   * The deadline is read once per iteration and passed to landing generation.
+   * An expansion cut short by the deadline is undone, so the tree only holds
+   * nodes with all their children. The root is always expanded, so a move is
+   * available whenever one exists.
+   *
+   * @param deadline The deadline of the search
+   * @param iterations The maximum number of iterations
+   * @return The number of iterations run
+   */
+  size_t run(const SearchDeadline& deadline,
+             size_t iterations = std::numeric_limits<size_t>::max());
+
+  /**
+   * @brief Move the root to the child reached by a placement
+   *
+   * The child's subtree keeps its statistics, the rest of the tree is
+   * discarded. Only the discarded nodes are visited.
+   *
+   * @param piece The landing of the placed piece
+   * @param useHold Whether the piece came from hold
+   * @return false if the root has no such child, the tree is then unchanged
+   */
+  bool advance(const PieceState& piece, bool useHold);
+
+  /**
+   * @brief Align the tree with the actual state of the game
+   *
+   * The root must hold the same board, hold, combo and back-to-back state as
+   * the state, and the pieces known to the tree must be a prefix of the
+   * state's current piece and preview. Pieces revealed since are appended,
+   * reopening the lines that ended at the old horizon and the hold branches
+   * that needed a piece past it.
+   *
+   * @param gameState The actual state
+   * @return false if the state differs, for instance after garbage, in which
+   * case the tree must be reset
+   */
+  bool sync(const GameState& gameState);
+
+  /**
+   * @brief Get the best placement found so far
+   *
+   * @return The placement, or std::nullopt if the root has no children
+   */
+  [[nodiscard]] std::optional<Result> getBestMove() const;
+
+  /**
+   * @brief Search a state from scratch
+   *
+   * @param gameState The state to search from
+   * @param iterations The maximum number of iterations
+   * @return The placement, or std::nullopt if no piece can be placed
+   */
+  [[nodiscard]] std::optional<Result> search(const GameState& gameState,
+                                             size_t iterations);
+
+  /**
+   * @brief Search a state from scratch until a deadline
+   *
+   * @param gameState The state to search from
+   * @param deadline The deadline of the search
+   * @return The placement, or std::nullopt if no piece can be placed
+   */
+  [[nodiscard]] std::optional<Result> search(const GameState& gameState,
+                                             const SearchDeadline& deadline);
+
+  /**
+   * @brief Get the configuration options
+   */
+  [[nodiscard]] const Config& getConfig() const { return m_config; }
+
+  /**
+   * @brief Set the configuration options
+   */
+  void setConfig(const Config& config) { m_config = config; }
+
+  /**
+   * @brief Get the number of nodes in the tree
+   */
+  [[nodiscard]] size_t getNodeCount() const {
+    return m_nodes.size() - m_freeNodes.size();
+  }
+
+  /**
+   * @brief Get the number of visits of the root
+   */
+  [[nodiscard]] uint32_t getRootVisits() const {
+    return m_nodes.empty() ? 0 : m_nodes.at(m_root).visits;
+  }
+
+private:
+  /**
+   * @brief Arena index marking a missing node or edge
+   */
+  static constexpr uint32_t noIndex{~uint32_t{0}};
+
+  /**
+   * @brief A state after a placement
+   */
+  struct Node {
+    /**
+     * @brief Construct a node holding a board
+     */
+    explicit Node(const Board& nodeBoard) : board{nodeBoard} {}
+
+    Board board;                   ///< Board after the placement
+    std::optional<PieceType> held; ///< Held piece after the placement
+    int32_t queueIndex{0};         ///< Sequence index of the next piece
+    int32_t combo{0};              ///< Combo after the placement
+    bool backToBack{false};        ///< Back-to-back state after it
+    uint32_t firstEdge{noIndex};   ///< Edge arena index of the first child
+    uint32_t edgeCount{0};         ///< Number of children
+    uint32_t parentCount{0};       ///< Number of edges leading to the node
+    uint32_t visits{0};            ///< Number of iterations through the node
+    double value{0.0};             ///< Evaluation, then best backed-up value
+    bool expanded{false};          ///< Whether the children were generated
+    bool exhausted{false};         ///< Whether no descendant can be expanded
+    bool holdPending{false};       ///< Hold branch waits for the next piece
+  };
+
+  /**
+   * @brief A placement leading from a node to a child
+   */
+  struct Edge {
+    PieceState piece;     ///< Landing of the placed piece
+    int32_t tSpinType{0}; ///< T-spin type of the landing
+    bool useHold{false};  ///< Whether the piece comes from hold
+    uint32_t child{0};    ///< Node arena index of the child
+    double reward{0.0};   ///< Attack reward of the placement
+  };
+
+  /**
+   * @brief Generate the children of a node
+   *
+   * @param nodeIndex Node arena index of the node
+   * @param deadline The deadline of the landing generation
+   * @return false if the deadline expired and the expansion was undone
+   */
+  bool expand(uint32_t nodeIndex, const SearchDeadline& deadline);
+
+  /**
+   * @brief Add the hold branch of an expanded node once its piece is known
+   *
+   * With an empty hold, holding places the piece after the current one. A
+   * node expanded while that piece was past the horizon gets the branch when
+   * sync() reveals it.
+   *
+   * @param nodeIndex Node arena index of the node
+   * @param deadline The deadline of the landing generation
+   * @return false if the deadline expired and the branch was undone
+   */
+  bool expandHold(uint32_t nodeIndex, const SearchDeadline& deadline);
+
+  /**
+   * @brief Check whether a node can get its pending hold branch
+   */
+  [[nodiscard]] bool canExpandHold(const Node& node) const {
+    return node.holdPending &&
+           node.queueIndex + 1 < static_cast<int32_t>(m_sequence.size());
+  }
+
+  /**
+   * @brief Remove the edges and nodes added since an expansion started
+   *
+   * @param edgeCount The size of the edge arena before the expansion
+   */
+  void undoExpansion(size_t edgeCount);
+
+  /**
+   * @brief Store the children of a node, just appended to the edge arena, in
+   * a discarded block of the same length if there is one
+   *
+   * @param nodeIndex Node arena index of the node
+   * @param edgeCount The size of the edge arena before the children
+   */
+  void placeEdges(uint32_t nodeIndex, size_t edgeCount);
+
+  /**
+   * @brief Add the children placing one piece type
+   *
+   * @param nodeIndex Node arena index of the parent
+   * @param type The piece to place
+   * @param held The held piece after the placement
+   * @param queueIndex The sequence index of the next piece afterwards
+   * @param useHold Whether the piece comes from hold
+   * @param deadline The deadline of the landing generation
+   */
+  void expandPiece(uint32_t nodeIndex, PieceType type,
+                   std::optional<PieceType> held, int32_t queueIndex,
+                   bool useHold, const SearchDeadline& deadline);
+
+  /**
+   * @brief Get the landings of a piece on a board, generating them once
+   *
+   * @param board The board
+   * @param type The piece type
+   * @param deadline The deadline of the landing generation
+   * @return The landings, or nullptr if the deadline expired
+   */
+  const std::vector<LandingPosition>*
+  getLandings(const Board& board, PieceType type,
+              const SearchDeadline& deadline);
+
+  /**
+   * @brief Compute the expected value of a leaf past the known pieces
+   *
+   * @param nodeIndex Node arena index of the leaf
+   * @param deadline The deadline of the landing generation
+   * @return The mean over the bag of the best reward plus evaluation, or
+   * std::nullopt if the deadline expired
+   */
+  [[nodiscard]] std::optional<double>
+  getBagExpectation(uint32_t nodeIndex, const SearchDeadline& deadline);
+
+  /**
+   * @brief Store a node in a free arena slot, or at the end of the arena
+   *
+   * @param node The node
+   * @return Node arena index of the node
+   */
+  uint32_t allocateNode(Node&& node);
+
+  /**
+   * @brief Discard a node and the descendants left without parents
+   *
+   * @param nodeIndex Node arena index of the node
+   */
+  void release(uint32_t nodeIndex);
+
+  /**
+   * @brief Pick the child of a node to descend into
+   *
+   * @param nodeIndex Node arena index of the node
+   * @return Edge arena index of the child, noIndex if all are exhausted
+   */
+  [[nodiscard]] uint32_t select(uint32_t nodeIndex) const;
+
+  /**
+   * @brief Recompute the value and exhausted flag of an expanded node
+   *
+   * @param nodeIndex Node arena index of the node
+   */
+  void backup(uint32_t nodeIndex);
+
+  /**
+   * @brief Get the children of a node
+   */
+  [[nodiscard]] std::span<const Edge> getEdges(const Node& node) const;
+
+  /**
+   * @brief Get the hash identifying a node's state
+   */
+  [[nodiscard]] uint64_t getNodeKey(const Node& node) const;
+
+  std::shared_ptr<const SearchAlgorithm> m_movegen; ///< Landing generator
+  std::shared_ptr<const Evaluator> m_evaluator;     ///< Placement evaluator
+  AttackTable m_attackTable;                        ///< Attack rules
+  Config m_config;                                  ///< Search configuration
+
+  std::optional<GameState> m_rootState; ///< State the tree was built from
+  std::optional<GameState> m_scratch;   ///< State used for landing generation
+  std::vector<PieceType> m_sequence;    ///< Current piece followed by preview
+  BagState m_horizonBag;                ///< Bag after the known pieces
+  bool m_rootHoldUsed{false};           ///< Whether hold is locked at the root
+  std::vector<Node> m_nodes;            ///< Node arena
+  std::vector<Edge> m_edges;            ///< Edge arena, children contiguous
+  uint32_t m_root{0};                   ///< Node arena index of the root
+  std::unordered_map<uint64_t, uint32_t>
+      m_nodeIndex;                      ///< Node arena index by state hash
+  std::vector<uint32_t> m_freeNodes;    ///< Discarded node arena slots
+  std::vector<std::vector<uint32_t>>
+      m_freeEdgeBlocks;                 ///< Discarded edge blocks by length
+  std::vector<uint32_t> m_newNodes;     ///< Nodes created by an expansion
+  std::unordered_map<uint64_t, std::vector<LandingPosition>>
+      m_landingCache;                   ///< Landings by board and piece key
+  std::vector<uint32_t> m_path;         ///< Nodes visited by an iteration
+};
+
+} // namespace tetris
@@ -1,4 +1,5 @@
 #include "path_search.hpp"
+#include "../core/placement.hpp"
 #include "search_algorithm.hpp"
 #include <algorithm>
 #include <cstdint>
@@ -15,7 +16,14 @@ void PathSearch::initialize(const Config& config) { m_config = config; }
 
 std::vector<LandingPosition>
 PathSearch::findLandingPositions(const GameState& gameState, const Piece& piece,
-                                 size_t maxDepth) const {
+                                 const size_t maxDepth) const {
+  return findLandingPositions(gameState, piece, maxDepth, SearchDeadline{});
+}
+
+std::vector<LandingPosition>
+PathSearch::findLandingPositions(const GameState& gameState, const Piece& piece,
+                                 size_t maxDepth,
+                                 const SearchDeadline& deadline) const {
   std::vector<LandingPosition> landingPositions{};
 
   // Use a queue for BFS
@@ -31,7 +39,7 @@ PathSearch::findLandingPositions(const GameState& gameState, const Piece& piece,
   visited.insert(piece.getState());
 
   // BFS to find all reachable landing positions
-  while (!queue.empty()) {
+  while (!queue.empty() && !deadline.expired()) {
     auto currentNode{queue.front()};
     queue.pop();
 
@@ -60,6 +68,10 @@ PathSearch::findLandingPositions(const GameState& gameState, const Piece& piece,
       int32_t tSpinType{detectTSpin(gameState, currentNode->piece, lastMoveWasRotation)};
       landingPos.setTSpinType(tSpinType);
 
+      // Count the rows the piece completes
+      landingPos.setLinesCleared(
+          countClearedLines(gameState.getBoard(), currentNode->piece));
+
       // Add to the landing positions
       landingPositions.push_back(landingPos);
     }
@@ -154,7 +166,7 @@ bool PathSearch::canPlacePiece(const GameState& gameState,
 }
 
 std::vector<Move>
-PathSearch::reconstructPath(std::shared_ptr<SearchNode>& node) {
+PathSearch::reconstructPath(std::shared_ptr<SearchNode> node) {
   std::vector<Move> path{};
 
   // Traverse up the parent chain to reconstruct the path
@@ -265,32 +277,17 @@ Piece PathSearch::applyHardDrop(const GameState& gameState, const Piece& piece)
   PieceState newState{piece.getState()};
   Position newPos{newState.getPosition()};
 
-  // Binary search approach for hard drop
-  int32_t low{0};
-  int32_t high{gameState.getBoard().getHeight()};
-
-  while (low < high) {
-    const int32_t mid {low + (high - low) / 2};
-
-    Position testPos{ newPos};
-    testPos.yPos -= mid;
-
-    PieceState testState{newState};
-    testState.setPosition(testPos);
-
-    Piece testPiece{newPiece};
+  // Step down until the next row collides; a bisection over the drop
+  // distance would tunnel through overhangs into cavities below them
+  Piece testPiece{newPiece};
+  PieceState testState{newState};
+  while (true) {
+    testState.setPosition(Position{newPos.xPos, newPos.yPos - 1});
     testPiece.setState(testState);
-
-    if (canPlacePiece(gameState, testPiece)) {
-      low = mid + 1;
-    } else {
-      high = mid;
+    if (!canPlacePiece(gameState, testPiece)) {
+      break;
     }
-  }
-
-  // Move down by (low - 1) steps (or 0 if low is 0)
-  if (low > 0) {
-    newPos.yPos -= low - 1;
+    newPos.yPos -= 1;
   }
 
   newState.setPosition(newPos);
@@ -57,6 +57,22 @@ public:
   findLandingPositions(const GameState& gameState, const Piece& piece,
                        size_t maxDepth) const override;
 
+  /**
+   * @brief Find the landing positions reachable before a deadline
+   *
+   * The deadline is polled once per explored piece state.
+   *
+   * @param gameState The current game state
+   * @param piece The piece to place
+   * @param maxDepth Maximum search depth (0 for unlimited)
+   * @param deadline The deadline of the search
+   * @return Vector of landing positions found before the deadline expired
+   */
+  [[nodiscard]] std::vector<LandingPosition>
+  findLandingPositions(const GameState& gameState, const Piece& piece,
+                       size_t maxDepth,
+                       const SearchDeadline& deadline) const override;
+
   /**
    * @brief Find the path of moves to reach a landing position
    *
@@ -79,6 +95,18 @@ public:
   [[nodiscard]] bool canPlacePiece(const GameState& gameState,
                                    const Piece& piece) const override;
 
+  /**
+   * @brief Detect if a T-piece placement results in a T-spin
+   *
+   * @param gameState The current game state
+   * @param piece The T-piece to check
+   * @param lastMoveWasRotation Whether the last move was a rotation
+   * @return T-spin type (0=None, 1=T-Spin, 2=T-Spin Mini)
+   */
+  [[nodiscard]] static int32_t detectTSpin(const GameState& gameState,
+                                           const Piece& piece,
+                                           bool lastMoveWasRotation);
+
 private:
   /**
    * @brief Internal structure for BFS search
@@ -122,7 +150,7 @@ private:
    * @return Vector of moves to reach the target
    */
   [[nodiscard]] static std::vector<Move>
-  reconstructPath(std::shared_ptr<SearchNode>& node);
+  reconstructPath(std::shared_ptr<SearchNode> node);
 
   /**
    * @brief Check if a move is valid in the current game state
@@ -176,17 +204,6 @@ private:
   [[nodiscard]] Piece applyHardDrop(const GameState& gameState,
                                    const Piece& piece) const;
 
-  /**
-   * @brief Detect if a T-piece placement results in a T-spin
-   *
-   * @param gameState The current game state
-   * @param piece The T-piece to check
-   * @param lastMoveWasRotation Whether the last move was a rotation
-   * @return T-spin type (0=None, 1=T-Spin, 2=T-Spin Mini)
-   */
-  [[nodiscard]] static int32_t detectTSpin(const GameState& gameState,
-                                   const Piece& piece,
-                                   bool lastMoveWasRotation) ;
 };
 
 } // namespace tetris
\ No newline at end of file
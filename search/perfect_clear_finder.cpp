@@ -0,0 +1,277 @@
+#include "perfect_clear_finder.hpp"
+#include "../core/zobrist.hpp"
+#include "../rotation_systems/rotation_system.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <utility>
+
+namespace tetris {
+
+std::optional<std::vector<PerfectClearFinder::Step>>
+PerfectClearFinder::find(const GameState& gameState,
+                         const SearchDeadline& deadline) {
+  m_nodeCount = 0;
+  const Board& board{gameState.getBoard()};
+  [[unlikely]] if (board.getWidth() * m_config.maxHeight > 64) {
+    throw std::invalid_argument("Perfect clear rows must fit in 64 bits");
+  }
+  if (gameState.isGameOver() || !gameState.getRotationSystem() ||
+      board.getRoof() > m_config.maxHeight) {
+    return std::nullopt;
+  }
+  buildShapes(gameState);
+
+  m_sequence.clear();
+  m_sequence.push_back(gameState.getCurrentPiece().getState().getType());
+  m_sequence.insert(m_sequence.end(), gameState.getNextPieces().begin(),
+                    gameState.getNextPieces().end());
+  const std::optional<PieceType> held{gameState.getHeldPiece()};
+  const auto pieceCount{static_cast<int32_t>(m_sequence.size())};
+
+  uint64_t packed{0};
+  for (int32_t row{0}; row < board.getRoof(); ++row) {
+    packed |= static_cast<uint64_t>(board.getRow(row))
+              << static_cast<uint32_t>(row * m_width);
+  }
+
+  // Fill as few rows as possible; the cell count decides which heights can
+  // be filled by whole pieces
+  for (int32_t rows{std::max(board.getRoof(), 1)}; rows <= m_config.maxHeight;
+       ++rows) {
+    if (!isFeasible(packed, rows, pieceCount)) {
+      continue;
+    }
+
+    m_failed.clear();
+    m_steps.clear();
+    m_aborted = false;
+    if (solve(packed, rows, 0, held,
+              m_config.allowHold && !gameState.isHoldUsed(), deadline)) {
+      return m_steps;
+    }
+    if (m_aborted) {
+      break;
+    }
+  }
+  return std::nullopt;
+}
+
+size_t PerfectClearFinder::FailedStateHash::operator()(
+    const FailedState& state) const {
+  uint64_t queueState{static_cast<uint64_t>(state.queueIndex)};
+  return static_cast<size_t>(state.board ^ splitMix64(queueState) ^
+                             getHoldKey(state.held));
+}
+
+void PerfectClearFinder::buildShapes(const GameState& gameState) {
+  const auto rotationSystem{gameState.getRotationSystem()};
+  const int32_t width{gameState.getBoard().getWidth()};
+  // Compare owners rather than addresses: a new rotation system may be
+  // allocated where a freed one was
+  const bool sameSystem{!m_shapeSystem.owner_before(rotationSystem) &&
+                        !rotationSystem.owner_before(m_shapeSystem)};
+  if (sameSystem && width == m_width) {
+    return;
+  }
+  m_shapeSystem = rotationSystem;
+  m_width = width;
+
+  // Columns over every row the packed board holds
+  m_columnMasks.assign(static_cast<size_t>(width), 0);
+  for (int32_t cell{0}; cell < 64; ++cell) {
+    m_columnMasks.at(static_cast<size_t>(cell % width)) |=
+        uint64_t{1} << static_cast<uint32_t>(cell);
+  }
+
+  for (size_t typeIndex{0}; typeIndex < pieceTypeCount; ++typeIndex) {
+    const auto type{static_cast<PieceType>(typeIndex)};
+    std::vector<Shape>& shapes{m_shapes.at(typeIndex)};
+    shapes.clear();
+
+    std::vector<uint64_t> seen{};
+    for (const Rotation rotation :
+         {Rotation::R0, Rotation::R90, Rotation::R180, Rotation::R270}) {
+      const Piece piece{PieceState{type, Position{0, 0}, rotation},
+                        rotationSystem};
+      const auto& shapeData{piece.getShapeData()};
+      std::array<uint32_t, Piece::maxSize> rowBits{};
+      int32_t bottom{-1};
+      int32_t top{0};
+      uint32_t columns{0};
+      for (size_t y{0}; y < Piece::maxSize; ++y) {
+        // Shape bits are stored row-major with bit (y * maxSize + x)
+        rowBits.at(y) = static_cast<uint32_t>(
+            (shapeData >> (y * Piece::maxSize)).to_ulong() & 0xFU);
+        if (rowBits.at(y) != 0) {
+          bottom = bottom < 0 ? static_cast<int32_t>(y) : bottom;
+          top = static_cast<int32_t>(y) + 1;
+          columns |= rowBits.at(y);
+        }
+      }
+      const int32_t left{std::countr_zero(columns)};
+      const int32_t right{static_cast<int32_t>(std::bit_width(columns))};
+
+      // Rotations with the same cells, like those of O, give one shape per
+      // column; they differ only in the box position
+      for (int32_t xPos{-left}; xPos + right <= width; ++xPos) {
+        Shape shape{.rotation = rotation,
+                    .xPos = xPos,
+                    .bottom = bottom,
+                    .height = top - bottom};
+        for (int32_t row{0}; row < shape.height; ++row) {
+          const uint32_t bits{rowBits.at(static_cast<size_t>(bottom + row))};
+          const uint32_t shifted{xPos >= 0 ? bits << xPos : bits >> -xPos};
+          shape.cells |= static_cast<uint64_t>(shifted)
+                         << static_cast<uint32_t>(row * width);
+        }
+        if (std::ranges::find(seen, shape.cells) == seen.end()) {
+          seen.push_back(shape.cells);
+          shapes.push_back(shape);
+        }
+      }
+    }
+  }
+}
+
+bool PerfectClearFinder::solve(const uint64_t board, const int32_t rows,
+                               const int32_t queueIndex,
+                               const std::optional<PieceType> held,
+                               const bool holdAllowed,
+                               const SearchDeadline& deadline) {
+  if (++m_nodeCount > m_config.maxNodes || deadline.expired()) {
+    m_aborted = true;
+    return false;
+  }
+
+  // The held piece only replaces a piece of the queue, it adds none
+  const auto sequenceSize{static_cast<int32_t>(m_sequence.size())};
+  if (!isFeasible(board, rows, sequenceSize - queueIndex)) {
+    return false;
+  }
+  const FailedState state{.board = board, .queueIndex = queueIndex,
+                          .held = held};
+  if (m_failed.contains(state)) {
+    return false;
+  }
+
+  // Place the next piece, or hold it and place the held piece or the one
+  // after it
+  const PieceType current{m_sequence.at(queueIndex)};
+  if (solvePiece(board, rows, current, held, queueIndex + 1, false,
+                 deadline)) {
+    return true;
+  }
+  if (holdAllowed && held.has_value() && *held != current &&
+      solvePiece(board, rows, *held, current, queueIndex + 1, true,
+                 deadline)) {
+    return true;
+  }
+  if (holdAllowed && !held.has_value() && queueIndex + 1 < sequenceSize &&
+      solvePiece(board, rows, m_sequence.at(queueIndex + 1), current,
+                 queueIndex + 2, true, deadline)) {
+    return true;
+  }
+
+  // A cut search proves nothing about the state
+  if (!m_aborted) {
+    m_failed.insert(state);
+  }
+  return false;
+}
+
+bool PerfectClearFinder::solvePiece(const uint64_t board, const int32_t rows,
+                                    const PieceType type,
+                                    const std::optional<PieceType> held,
+                                    const int32_t nextQueueIndex,
+                                    const bool useHold,
+                                    const SearchDeadline& deadline) {
+  const auto width{static_cast<uint32_t>(m_width)};
+  const auto fullRow{(uint64_t{1} << width) - 1};
+
+  for (const Shape& shape : m_shapes.at(static_cast<size_t>(
+           std::to_underlying(type)))) {
+    // Drop from the top row the shape fits under; colliding there means the
+    // piece would stop above the rows to fill
+    int32_t row{rows - shape.height};
+    if (row < 0 ||
+        (board & (shape.cells << static_cast<uint32_t>(row) * width)) != 0) {
+      continue;
+    }
+    while (row > 0 && (board & (shape.cells << static_cast<uint32_t>(row - 1) *
+                                                   width)) == 0) {
+      --row;
+    }
+
+    // Clear the full rows the piece completed, top first so lower rows keep
+    // their index
+    uint64_t next{board | (shape.cells << static_cast<uint32_t>(row) * width)};
+    int32_t nextRows{rows};
+    for (int32_t clear{row + shape.height - 1}; clear >= row; --clear) {
+      const auto shift{static_cast<uint32_t>(clear) * width};
+      if (((next >> shift) & fullRow) == fullRow) {
+        const uint64_t below{next & ((uint64_t{1} << shift) - 1)};
+        // The top row of a full 64-bit board has nothing above it, and
+        // shifting by 64 would be undefined
+        const uint64_t above{shift + width >= 64 ? 0
+                                                 : next >> (shift + width)};
+        next = below | (above << shift);
+        --nextRows;
+      }
+    }
+
+    m_steps.push_back(
+        Step{.piece = PieceState{type,
+                                 Position{shape.xPos, row - shape.bottom},
+                                 shape.rotation},
+             .useHold = useHold});
+    if (next == 0 || solve(next, nextRows, nextQueueIndex, held,
+                           m_config.allowHold, deadline)) {
+      return true;
+    }
+    m_steps.pop_back();
+    if (m_aborted) {
+      return false;
+    }
+  }
+  return false;
+}
+
+bool PerfectClearFinder::isFeasible(const uint64_t board, const int32_t rows,
+                                    const int32_t pieceCount) const {
+  const uint64_t area{getRowsMask(rows)};
+  const uint64_t empty{~board & area};
+  const int32_t emptyCount{std::popcount(empty)};
+  if (emptyCount % 4 != 0 || emptyCount / 4 > pieceCount) {
+    return false;
+  }
+
+  // A drop cannot reach an empty cell under a filled one
+  const auto width{static_cast<uint32_t>(m_width)};
+  if (((board >> width) & empty) != 0) {
+    return false;
+  }
+
+  // Without covered cells, a column is either full or open to its
+  // neighbours; every stretch between full columns is filled on its own
+  int32_t stretch{0};
+  for (const uint64_t columnMask : m_columnMasks) {
+    const int32_t columnEmpty{std::popcount(empty & columnMask)};
+    if (columnEmpty == 0) {
+      if (stretch % 4 != 0) {
+        return false;
+      }
+      stretch = 0;
+    }
+    stretch += columnEmpty;
+  }
+  return true;
+}
+
+uint64_t PerfectClearFinder::getRowsMask(const int32_t rows) const {
+  const auto cells{static_cast<uint32_t>(rows * m_width)};
+  return cells >= 64 ? ~uint64_t{0} : (uint64_t{1} << cells) - 1;
+}
+
+} // namespace tetris
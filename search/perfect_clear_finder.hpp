@@ -0,0 +1,182 @@
+#pragma once
+
+#include "../core/game_state.hpp"
+#include "search_deadline.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+namespace tetris {
+
+/**
+ * @class PerfectClearFinder
+ * @brief Depth-first solver for sequences that empty the board
+ *
+ * The bottom rows of the board are packed into one 64-bit word, row after
+ * row, so placing a piece, testing collisions and clearing rows are a few
+ * shifts and masks. A solution fills a fixed number of rows completely: the
+ * finder tries the lowest row counts whose empty cells are a multiple of four
+ * and can be covered by the available pieces.
+ *
+ * Pieces are dropped straight down from above the filled rows, so the
+ * solutions need no soft drop or spin and the board above them must be
+ * empty. Branches are pruned when an empty cell is covered, since a straight
+ * drop cannot fill it, and when a full column walls off a region whose size is
+ * not a multiple of four. Board, queue position and hold of failed branches
+ * are remembered, so transpositions are searched once.
+ */
+class PerfectClearFinder {
+public:
+  /**
+   * @brief Configuration options for the finder
+   */
+  struct Config {
+    int32_t maxHeight{4};              ///< Rows a solution may fill
+    bool allowHold{true};              ///< Whether solutions may hold
+    size_t maxNodes{size_t{1} << 20U}; ///< Branches tried before giving up
+  };
+
+  /**
+   * @brief One placement of a solution
+   */
+  struct Step {
+    PieceState piece;    ///< Landing of the piece, reachable by a drop
+    bool useHold{false}; ///< Whether to hold before placing
+  };
+
+  /**
+   * @brief Construct a finder with the default configuration
+   */
+  PerfectClearFinder() = default;
+
+  /**
+   * @brief Construct a finder
+   *
+   * @param config The finder configuration
+   */
+  explicit PerfectClearFinder(const Config& config) : m_config{config} {}
+
+  /**
+   * @brief Find placements of the current, held and preview pieces that
+   * empty the board
+   *
+   * @param gameState The state to solve; its current piece must be spawned
+   * @param deadline The deadline of the search
+   * @return The placements in order, or std::nullopt if none was found
+   * @throws std::invalid_argument if maxHeight rows of the board do not fit
+   * in 64 bits
+   */
+  [[nodiscard]] std::optional<std::vector<Step>>
+  find(const GameState& gameState, const SearchDeadline& deadline = {});
+
+  /**
+   * @brief Get the configuration options
+   */
+  [[nodiscard]] const Config& getConfig() const { return m_config; }
+
+  /**
+   * @brief Set the configuration options
+   */
+  void setConfig(const Config& config) { m_config = config; }
+
+  /**
+   * @brief Get the number of branches tried by the last search
+   */
+  [[nodiscard]] size_t getNodeCount() const { return m_nodeCount; }
+
+private:
+  /**
+   * @brief A piece rotation at one column
+   */
+  struct Shape {
+    Rotation rotation{Rotation::R0}; ///< Rotation of the piece
+    int32_t xPos{0};                 ///< Column of the shape box
+    int32_t bottom{0};               ///< Lowest filled row of the shape box
+    int32_t height{0};               ///< Number of filled rows
+    uint64_t cells{0};               ///< Packed cells, lowest row at row 0
+  };
+
+  /**
+   * @brief A state whose search found no solution
+   */
+  struct FailedState {
+    uint64_t board{0};             ///< Packed board
+    int32_t queueIndex{0};         ///< Sequence index of the next piece
+    std::optional<PieceType> held; ///< Held piece
+
+    bool operator==(const FailedState& other) const = default;
+  };
+
+  /**
+   * @brief Hash of a failed state
+   */
+  struct FailedStateHash {
+    size_t operator()(const FailedState& state) const;
+  };
+
+  /**
+   * @brief Build the shapes of every piece for a board width
+   *
+   * @param gameState The state giving the rotation system and width
+   */
+  void buildShapes(const GameState& gameState);
+
+  /**
+   * @brief Search placements from a state
+   *
+   * @param board The packed board
+   * @param rows The number of rows left to fill
+   * @param queueIndex Sequence index of the next piece
+   * @param held The held piece
+   * @param holdAllowed Whether the next piece may be held
+   * @param deadline The deadline of the search
+   * @return true if a solution was found, its steps are in m_steps
+   */
+  bool solve(uint64_t board, int32_t rows, int32_t queueIndex,
+             std::optional<PieceType> held, bool holdAllowed,
+             const SearchDeadline& deadline);
+
+  /**
+   * @brief Try every placement of one piece
+   *
+   * @return true if a solution was found
+   */
+  bool solvePiece(uint64_t board, int32_t rows, PieceType type,
+                  std::optional<PieceType> held, int32_t nextQueueIndex,
+                  bool useHold, const SearchDeadline& deadline);
+
+  /**
+   * @brief Check the cell-count and column conditions of a solvable board
+   *
+   * @param board The packed board
+   * @param rows The number of rows left to fill
+   * @param pieceCount The number of pieces still available
+   * @return false if no sequence of drops can fill the rows
+   */
+  [[nodiscard]] bool isFeasible(uint64_t board, int32_t rows,
+                                int32_t pieceCount) const;
+
+  /**
+   * @brief Get the mask of the first rows of the packed board
+   */
+  [[nodiscard]] uint64_t getRowsMask(int32_t rows) const;
+
+  Config m_config; ///< Finder configuration
+
+  std::array<std::vector<Shape>, pieceTypeCount>
+      m_shapes;                                ///< Shapes by piece type
+  std::weak_ptr<RotationSystem> m_shapeSystem; ///< Rotation system of m_shapes
+  int32_t m_width{0};                          ///< Board width of m_shapes
+  std::vector<uint64_t> m_columnMasks;         ///< Packed cells of each column
+  std::vector<PieceType> m_sequence;           ///< Current piece then preview
+  std::vector<Step> m_steps;                   ///< Placements of the branch
+  std::unordered_set<FailedState, FailedStateHash>
+      m_failed;                                ///< States without solution
+  size_t m_nodeCount{0};                       ///< Branches tried
+  bool m_aborted{false};                       ///< Whether the search was cut
+};
+
+} // namespace tetris
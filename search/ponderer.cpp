@@ -0,0 +1,51 @@
+#include "ponderer.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace tetris {
+
+Ponderer::Ponderer(std::shared_ptr<MonteCarloTreeSearch> search)
+    : m_search{std::move(search)} {
+  [[unlikely]] if (!m_search) {
+    throw std::invalid_argument("Ponderer requires a tree search");
+  }
+}
+
+Ponderer::~Ponderer() { stop(); }
+
+std::optional<MonteCarloTreeSearch::Result>
+Ponderer::think(const GameState& gameState, const SearchDeadline& deadline) {
+  stop();
+
+  m_treeReused = m_search->sync(gameState);
+  if (!m_treeReused) {
+    m_search->reset(gameState);
+  }
+  m_search->run(deadline);
+  return m_search->getBestMove();
+}
+
+void Ponderer::ponder(const MonteCarloTreeSearch::Result& move) {
+  stop();
+
+  m_ponderIterations.store(0);
+  if (!m_search->advance(move.landing.getPiece().getState(), move.useHold)) {
+    return;
+  }
+
+  m_thread = std::jthread{[this](std::stop_token stopToken) {
+    m_ponderIterations.store(
+        m_search->run(SearchDeadline{std::move(stopToken)}));
+  }};
+}
+
+void Ponderer::stop() {
+  if (!m_thread.joinable()) {
+    return;
+  }
+  m_thread.request_stop();
+  m_thread.join();
+}
+
+} // namespace tetris
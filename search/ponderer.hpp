@@ -0,0 +1,92 @@
+#pragma once
+
+#include "monte_carlo_tree_search.hpp"
+#include "search_deadline.hpp"
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <thread>
+
+namespace tetris {
+
+/**
+ * @class Ponderer
+ * @brief Keeps a tree search running between pieces
+ *
+ * After a move is chosen, the tree is moved to the state that move leads to
+ * and grown on a background thread until the next decision. When the actual
+ * state arrives the tree is kept if it still matches, with the newly revealed
+ * preview piece appended, and rebuilt otherwise, for instance after garbage.
+ *
+ * The search must not be used by anyone else while it is pondering.
+ */
+class Ponderer {
+public:
+  /**
+   * @brief Construct a ponderer driving a tree search
+   *
+   * @param search The tree search
+   * @throws std::invalid_argument if search is null
+   */
+  explicit Ponderer(std::shared_ptr<MonteCarloTreeSearch> search);
+
+  /**
+   * @brief Stop pondering
+   */
+  ~Ponderer();
+
+  Ponderer(const Ponderer&) = delete;
+  Ponderer& operator=(const Ponderer&) = delete;
+
+  /**
+   * @brief Choose the move to play in a state
+   *
+   * Stops pondering, keeps the tree when it matches the state and searches
+   * until the deadline.
+   *
+   * @param gameState The actual state
+   * @param deadline The deadline of the decision
+   * @return The placement, or std::nullopt if no piece can be placed
+   */
+  [[nodiscard]] std::optional<MonteCarloTreeSearch::Result>
+  think(const GameState& gameState, const SearchDeadline& deadline);
+
+  /**
+   * @brief Commit to a move and ponder the state it leads to
+   *
+   * Does nothing if the move is not a child of the root.
+   *
+   * @param move The move returned by think()
+   */
+  void ponder(const MonteCarloTreeSearch::Result& move);
+
+  /**
+   * @brief Stop the background search and wait for it
+   */
+  void stop();
+
+  /**
+   * @brief Check whether the background search is running
+   */
+  [[nodiscard]] bool isPondering() const { return m_thread.joinable(); }
+
+  /**
+   * @brief Check whether the last think() kept the pondered tree
+   */
+  [[nodiscard]] bool wasTreeReused() const { return m_treeReused; }
+
+  /**
+   * @brief Get the number of iterations run by the last background search
+   */
+  [[nodiscard]] size_t getPonderIterations() const {
+    return m_ponderIterations.load();
+  }
+
+private:
+  std::shared_ptr<MonteCarloTreeSearch> m_search; ///< The tree search
+  std::jthread m_thread;                          ///< Background search
+  std::atomic<size_t> m_ponderIterations{0};      ///< Background iterations
+  bool m_treeReused{false};                       ///< Last think() kept tree
+};
+
+} // namespace tetris
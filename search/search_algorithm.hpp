@@ -3,6 +3,7 @@
 #include "../core/game_state.hpp"
 #include "../core/move.hpp"
 #include "../core/tetris_piece.hpp"
+#include "search_deadline.hpp"
 #include <cstdint>
 #include <string_view>
 #include <utility>
@@ -147,6 +148,25 @@ public:
   findLandingPositions(const GameState& gameState, const Piece& piece,
                        size_t maxDepth) const = 0;
 
+  /**
+   * @brief Find the landing positions reachable before a deadline
+   *
+   * The search stops early once the deadline expires and returns the landing
+   * positions found so far. The default implementation ignores the deadline.
+   *
+   * @param gameState The current game state
+   * @param piece The piece to place
+   * @param maxDepth Maximum search depth (0 for unlimited)
+   * @param deadline The deadline of the search
+   * @return Vector of landing positions
+   */
+  [[nodiscard]] virtual std::vector<LandingPosition>
+  findLandingPositions(const GameState& gameState, const Piece& piece,
+                       size_t maxDepth, const SearchDeadline& deadline) const {
+    static_cast<void>(deadline);
+    return findLandingPositions(gameState, piece, maxDepth);
+  }
+
   /**
    * @brief Find the path of moves to reach a landing position
    *
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <stop_token>
+#include <utility>
+
+namespace tetris {
+
+/**
+ * @class SearchDeadline
+ * @brief Time limit and stop request shared by the layers of a search
+ *
+ * A deadline expires when its time point passes or when its stop token is
+ * signalled. expired() reads the clock only once every checkInterval calls,
+ * so it can be polled from inner loops; checkNow() reads it on every call for
+ * loops whose iterations are expensive. Once expired, a deadline stays
+ * expired.
+ *
+ * The call counter is not synchronized: each thread polls its own copy.
+ * Copies are cheap and keep the same time point and stop token.
+ */
+class SearchDeadline {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Default number of expired() calls between clock reads
+   */
+  static constexpr uint32_t defaultCheckInterval{64};
+
+  /**
+   * @brief Construct a deadline that never expires
+   */
+  SearchDeadline() = default;
+
+  /**
+   * @brief Construct a deadline expiring at a time point or on a stop request
+   *
+   * @param deadline The time point after which the search must stop
+   * @param stopToken Token whose stop request also expires the deadline
+   * @param checkInterval The number of expired() calls between clock reads
+   */
+  explicit SearchDeadline(const Clock::time_point deadline,
+                          std::stop_token stopToken = {},
+                          const uint32_t checkInterval = defaultCheckInterval)
+      : m_deadline{deadline}, m_stopToken{std::move(stopToken)},
+        m_checkInterval{checkInterval} {}
+
+  /**
+   * @brief Construct a deadline expiring only on a stop request
+   *
+   * @param stopToken Token whose stop request expires the deadline
+   */
+  explicit SearchDeadline(std::stop_token stopToken)
+      : m_stopToken{std::move(stopToken)} {}
+
+  /**
+   * @brief Construct a deadline expiring after a time budget from now
+   *
+   * @param budget The time the search may take
+   * @param stopToken Token whose stop request also expires the deadline
+   * @return The deadline
+   */
+  [[nodiscard]] static SearchDeadline after(const Clock::duration budget,
+                                            std::stop_token stopToken = {}) {
+    return SearchDeadline{Clock::now() + budget, std::move(stopToken)};
+  }
+
+  /**
+   * @brief Check whether the search must stop, reading the clock only
+   * periodically
+   *
+   * @return true once the deadline has passed or a stop was requested
+   */
+  [[nodiscard]] bool expired() const {
+    if (m_expired) {
+      return true;
+    }
+    if (++m_callCount < m_checkInterval) {
+      return false;
+    }
+    return checkNow();
+  }
+
+  /**
+   * @brief Check whether the search must stop, reading the clock now
+   *
+   * @return true once the deadline has passed or a stop was requested
+   */
+  [[nodiscard]] bool checkNow() const {
+    m_callCount = 0;
+    m_expired = m_expired || m_stopToken.stop_requested() ||
+                (hasTimeLimit() && Clock::now() >= m_deadline);
+    return m_expired;
+  }
+
+  /**
+   * @brief Check whether the deadline has a time point
+   */
+  [[nodiscard]] bool hasTimeLimit() const {
+    return m_deadline != Clock::time_point::max();
+  }
+
+  /**
+   * @brief Get the time point of the deadline, max() without a time limit
+   */
+  [[nodiscard]] Clock::time_point getTimePoint() const { return m_deadline; }
+
+private:
+  Clock::time_point m_deadline{Clock::time_point::max()}; ///< Time limit
+  std::stop_token m_stopToken;                            ///< Stop request
+  uint32_t m_checkInterval{defaultCheckInterval};         ///< Calls per read
+  mutable uint32_t m_callCount{0};                        ///< Calls since read
+  mutable bool m_expired{false};                          ///< Sticky expiry
+};
+
+} // namespace tetris
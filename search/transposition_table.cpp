@@ -0,0 +1,159 @@
+#include "transposition_table.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace tetris {
+
+namespace {
+
+/**
+ * @brief Depth an entry loses per search it is older than the current one
+ */
+constexpr int32_t agePenalty{8};
+
+/**
+ * @brief Number of buckets sampled by getOccupancy()
+ */
+constexpr size_t occupancySampleSize{1024};
+
+/**
+ * @brief Pack an entry into one word
+ */
+constexpr uint64_t pack(const TranspositionTable::Entry& entry) {
+  return uint64_t{std::bit_cast<uint32_t>(entry.score)} |
+         uint64_t{entry.depth} << 32U | uint64_t{entry.generation} << 40U |
+         uint64_t{entry.move} << 48U;
+}
+
+/**
+ * @brief Unpack an entry from one word
+ */
+constexpr TranspositionTable::Entry unpack(const uint64_t data) {
+  return TranspositionTable::Entry{
+      .score = std::bit_cast<float>(static_cast<uint32_t>(data)),
+      .depth = static_cast<uint8_t>(data >> 32U),
+      .generation = static_cast<uint8_t>(data >> 40U),
+      .move = static_cast<uint16_t>(data >> 48U)};
+}
+
+} // namespace
+
+TranspositionTable::TranspositionTable(const size_t sizeMb) {
+  resize(sizeMb);
+}
+
+void TranspositionTable::BucketDeleter::operator()(Bucket* buckets) const {
+  std::destroy_n(buckets, count);
+  ::operator delete(buckets, std::align_val_t{alignment});
+}
+
+void TranspositionTable::resize(const size_t sizeMb) {
+  const size_t bytes{std::max(sizeMb, size_t{1}) << 20U};
+  const size_t count{std::bit_floor(bytes / sizeof(Bucket))};
+  const size_t tableBytes{count * sizeof(Bucket)};
+  const size_t alignment{tableBytes >= hugePageSize ? hugePageSize
+                                                    : alignof(Bucket)};
+
+  m_buckets.reset();
+  m_bucketCount = 0;
+  auto* buckets{static_cast<Bucket*>(
+      ::operator new(tableBytes, std::align_val_t{alignment}))};
+
+#ifdef __linux__
+  // Ask for huge pages before the first touch; failure only costs TLB misses
+  if (alignment == hugePageSize) {
+    static_cast<void>(madvise(buckets, tableBytes, MADV_HUGEPAGE));
+  }
+#endif
+
+  std::uninitialized_default_construct_n(buckets, count);
+  m_buckets = std::unique_ptr<Bucket[], BucketDeleter>{
+      buckets, BucketDeleter{.count = count, .alignment = alignment}};
+  m_bucketCount = count;
+  m_generation.store(0, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear() {
+  for (size_t i{0}; i < m_bucketCount; ++i) {
+    for (Slot& slot : m_buckets[i].slots) {
+      slot.check.store(~uint64_t{0}, std::memory_order_relaxed);
+      slot.data.store(0, std::memory_order_relaxed);
+    }
+  }
+  m_generation.store(0, std::memory_order_relaxed);
+}
+
+std::optional<TranspositionTable::Entry>
+TranspositionTable::probe(const uint64_t key) const {
+  for (const Slot& slot : getBucket(key).slots) {
+    const uint64_t data{slot.data.load(std::memory_order_relaxed)};
+    if ((slot.check.load(std::memory_order_relaxed) ^ data) == key) {
+      return unpack(data);
+    }
+  }
+  return std::nullopt;
+}
+
+void TranspositionTable::store(const uint64_t key, const float score,
+                               const uint8_t depth, const uint16_t move) {
+  auto& slots{m_buckets[key & (m_bucketCount - 1)].slots};
+  const uint8_t generation{getGeneration()};
+
+  // Reuse the slot of the key if present, otherwise replace the slot with the
+  // lowest depth once aged
+  Slot* target{nullptr};
+  int32_t lowestPriority{std::numeric_limits<int32_t>::max()};
+  for (Slot& slot : slots) {
+    const uint64_t data{slot.data.load(std::memory_order_relaxed)};
+    const Entry entry{unpack(data)};
+    if ((slot.check.load(std::memory_order_relaxed) ^ data) == key) {
+      if (entry.generation == generation && entry.depth > depth) {
+        return;
+      }
+      target = &slot;
+      break;
+    }
+
+    const int32_t age{static_cast<uint8_t>(generation - entry.generation)};
+    const int32_t priority{entry.depth - agePenalty * age};
+    if (priority < lowestPriority) {
+      lowestPriority = priority;
+      target = &slot;
+    }
+  }
+
+  const uint64_t data{pack(Entry{.score = score,
+                                 .depth = depth,
+                                 .generation = generation,
+                                 .move = move})};
+  target->check.store(key ^ data, std::memory_order_relaxed);
+  target->data.store(data, std::memory_order_relaxed);
+}
+
+double TranspositionTable::getOccupancy() const {
+  const size_t sampleSize{std::min(occupancySampleSize, m_bucketCount)};
+  const uint8_t generation{getGeneration()};
+
+  size_t used{0};
+  for (size_t i{0}; i < sampleSize; ++i) {
+    for (const Slot& slot : m_buckets[i].slots) {
+      const uint64_t data{slot.data.load(std::memory_order_relaxed)};
+      const bool empty{(slot.check.load(std::memory_order_relaxed) ^ data) ==
+                       ~uint64_t{0}};
+      if (!empty && unpack(data).generation == generation) {
+        ++used;
+      }
+    }
+  }
+  return static_cast<double>(used) /
+         static_cast<double>(sampleSize * entriesPerBucket);
+}
+
+} // namespace tetris
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace tetris {
+
+/**
+ * @class TranspositionTable
+ * @brief Fixed-size table of search results keyed on a state hash
+ *
+ * Entries are grouped in buckets of one cache line, so a probe touches a
+ * single line and prefetch() can bring it in ahead of time. A store into a
+ * full bucket replaces the entry with the lowest depth, where entries from
+ * older searches count as shallower, so results of the current search survive
+ * and stale ones are recycled first.
+ *
+ * Each entry stores the key XOR-ed with its packed data word. A torn read
+ * from a concurrent store fails the key check and reads as a miss, so any
+ * number of search threads can share a table without a lock.
+ *
+ * Tables of at least one huge page are aligned to the huge page size and, on
+ * Linux, advised to be backed by transparent huge pages.
+ */
+class TranspositionTable {
+public:
+  /**
+   * @brief Default table size in megabytes
+   */
+  static constexpr size_t defaultSizeMb{16};
+
+  /**
+   * @brief A stored search result
+   */
+  struct Entry {
+    float score{0.0F};     ///< Score of the state
+    uint8_t depth{0};      ///< Depth the score was searched to
+    uint8_t generation{0}; ///< Search that stored the entry
+    uint16_t move{0};      ///< Best move, encoded by the search
+  };
+
+  /**
+   * @brief Construct a table
+   *
+   * @param sizeMb The table size in megabytes, rounded down to a power of two
+   * number of buckets
+   */
+  explicit TranspositionTable(size_t sizeMb = defaultSizeMb);
+
+  /**
+   * @brief Reallocate the table, discarding every entry
+   *
+   * Not thread-safe; no search may use the table meanwhile.
+   *
+   * @param sizeMb The table size in megabytes
+   */
+  void resize(size_t sizeMb);
+
+  /**
+   * @brief Remove all entries and restart the generation count
+   *
+   * Not thread-safe; no search may use the table meanwhile.
+   */
+  void clear();
+
+  /**
+   * @brief Start a new search, ageing the entries of the previous ones
+   */
+  void newSearch() { m_generation.fetch_add(1, std::memory_order_relaxed); }
+
+  /**
+   * @brief Get the generation of the current search
+   */
+  [[nodiscard]] uint8_t getGeneration() const {
+    return static_cast<uint8_t>(m_generation.load(std::memory_order_relaxed));
+  }
+
+  /**
+   * @brief Hint that a key will be probed or stored soon
+   *
+   * @param key The key
+   */
+  void prefetch(const uint64_t key) const {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(&getBucket(key));
+#else
+    static_cast<void>(key);
+#endif
+  }
+
+  /**
+   * @brief Look up the entry stored for a key
+   *
+   * @param key The key
+   * @return The entry, or std::nullopt on a miss
+   */
+  [[nodiscard]] std::optional<Entry> probe(uint64_t key) const;
+
+  /**
+   * @brief Store a search result
+   *
+   * An existing entry of the key from the current search is only overwritten
+   * by a result searched at least as deep.
+   *
+   * @param key The key
+   * @param score The score of the state
+   * @param depth The depth the score was searched to
+   * @param move The best move, encoded by the search
+   */
+  void store(uint64_t key, float score, uint8_t depth, uint16_t move = 0);
+
+  /**
+   * @brief Get the number of entries the table can hold
+   */
+  [[nodiscard]] size_t getCapacity() const {
+    return m_bucketCount * entriesPerBucket;
+  }
+
+  /**
+   * @brief Estimate the fill rate of the table
+   *
+   * Samples the first buckets for entries of the current search.
+   *
+   * @return The fraction of entries used by the current search, in [0, 1]
+   */
+  [[nodiscard]] double getOccupancy() const;
+
+private:
+  /**
+   * @brief Number of entries sharing one cache line
+   */
+  static constexpr size_t entriesPerBucket{4};
+
+  /**
+   * @brief Size of a transparent huge page
+   */
+  static constexpr size_t hugePageSize{size_t{2} << 20U};
+
+  /**
+   * @brief A table entry, verified by XOR-ing its two words
+   */
+  struct Slot {
+    std::atomic<uint64_t> check{~uint64_t{0}}; ///< key ^ data
+    std::atomic<uint64_t> data{0};             ///< Packed Entry
+  };
+
+  /**
+   * @brief One cache line of entries
+   */
+  struct alignas(64) Bucket {
+    std::array<Slot, entriesPerBucket> slots;
+  };
+
+  /**
+   * @brief Frees buckets allocated with the table alignment
+   */
+  struct BucketDeleter {
+    size_t count;     ///< Number of buckets
+    size_t alignment; ///< Alignment of the allocation
+
+    void operator()(Bucket* buckets) const;
+  };
+
+  /**
+   * @brief Get the bucket of a key
+   */
+  [[nodiscard]] const Bucket& getBucket(const uint64_t key) const {
+    return m_buckets[key & (m_bucketCount - 1)];
+  }
+
+  std::unique_ptr<Bucket[], BucketDeleter> m_buckets; ///< Table storage
+  size_t m_bucketCount{0};               ///< Number of buckets, power of 2
+  std::atomic<uint32_t> m_generation{0}; ///< Current search, low 8 bits used
+};
+
+} // namespace tetris
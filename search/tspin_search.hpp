@@ -72,6 +72,8 @@ public:
    */
   void initialize(const TSpinConfig& config);
 
+  using SearchAlgorithm::findLandingPositions;
+
   /**
    * @brief Find all possible landing positions for a piece
    *
@@ -0,0 +1,236 @@
+#include "work_stealing_executor.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+
+namespace tetris {
+
+namespace {
+
+/**
+ * @brief Executor whose worker is the calling thread, if any
+ */
+thread_local const WorkStealingExecutor* currentExecutor{nullptr};
+
+/**
+ * @brief Slot of the calling thread in currentExecutor
+ */
+thread_local size_t currentSlot{0};
+
+} // namespace
+
+WorkStealingExecutor::WorkStealingExecutor(size_t threadCount) {
+  if (threadCount == 0) {
+    threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+
+  m_workers.reserve(threadCount);
+  for (size_t slot{0}; slot < threadCount; ++slot) {
+    m_workers.push_back(std::make_unique<Worker>());
+  }
+
+  // Start the threads only once every deque exists, workers steal from all
+  m_threads.reserve(threadCount);
+  for (size_t slot{0}; slot < threadCount; ++slot) {
+    m_threads.emplace_back([this, slot] { run(slot); });
+  }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+  {
+    const std::lock_guard lock{m_sleepMutex};
+    m_stop = true;
+  }
+  m_wake.notify_all();
+
+  for (std::thread& thread : m_threads) {
+    thread.join();
+  }
+}
+
+size_t WorkStealingExecutor::getCurrentSlot() const {
+  return currentExecutor == this ? currentSlot : m_workers.size();
+}
+
+void WorkStealingExecutor::submit(Task task) {
+  const size_t slot{getCurrentSlot()};
+  const size_t target{slot < m_workers.size()
+                          ? slot
+                          : m_nextWorker.fetch_add(1, std::memory_order_relaxed) %
+                                m_workers.size()};
+
+  Worker& worker{*m_workers.at(target)};
+  {
+    const std::lock_guard lock{worker.mutex};
+    worker.tasks.push_back(std::move(task));
+    m_queuedTaskCount.fetch_add(1);
+  }
+  notifySleepers();
+}
+
+void WorkStealingExecutor::parallelFor(
+    const size_t count, const std::function<void(size_t)>& body,
+    size_t grainSize) {
+  grainSize = std::max(grainSize, size_t{1});
+  const size_t taskCount{(count + grainSize - 1) / grainSize};
+  if (taskCount <= 1) {
+    for (size_t i{0}; i < count; ++i) {
+      body(i);
+    }
+    return;
+  }
+
+  // Queued helpers may only run after the loop has returned, so the state
+  // they share with the caller lives on the heap
+  struct Loop {
+    std::atomic<size_t> nextTask{0};  ///< First range not yet claimed
+    std::atomic<size_t> remaining{0}; ///< Ranges not yet finished
+    std::mutex errorMutex;            ///< Guards error
+    std::exception_ptr error;         ///< First exception of the body
+  };
+  const auto loop{std::make_shared<Loop>()};
+  loop->remaining.store(taskCount, std::memory_order_relaxed);
+
+  // Claim and run ranges until none is left; the body is only touched while
+  // a range is unfinished, so it is still alive then
+  const auto runRanges{[&body, count, grainSize, taskCount](Loop& state) {
+    for (size_t task{state.nextTask.fetch_add(1, std::memory_order_relaxed)};
+         task < taskCount;
+         task = state.nextTask.fetch_add(1, std::memory_order_relaxed)) {
+      const size_t begin{task * grainSize};
+      const size_t end{std::min(begin + grainSize, count)};
+      try {
+        for (size_t i{begin}; i < end; ++i) {
+          body(i);
+        }
+      } catch (...) {
+        const std::lock_guard lock{state.errorMutex};
+        if (!state.error) {
+          state.error = std::current_exception();
+        }
+      }
+      state.remaining.fetch_sub(1, std::memory_order_acq_rel);
+    }
+  }};
+
+  // One helper per range but the first, the caller claims ranges as well
+  for (size_t task{1}; task < taskCount; ++task) {
+    submit([loop, runRanges] { runRanges(*loop); });
+  }
+  runRanges(*loop);
+
+  // A worker helps with queued tasks while the last ranges finish. Any other
+  // thread shares one slot with every thread outside the pool, so it only
+  // ever runs ranges of its own loop.
+  const size_t slot{getCurrentSlot()};
+  while (loop->remaining.load(std::memory_order_acquire) > 0) {
+    if (slot >= m_workers.size() || !runPendingTask(slot)) {
+      std::this_thread::yield();
+    }
+  }
+
+  if (loop->error) {
+    std::rethrow_exception(loop->error);
+  }
+}
+
+void WorkStealingExecutor::run(const size_t slot) {
+  currentExecutor = this;
+  currentSlot = slot;
+
+  while (true) {
+    if (runPendingTask(slot)) {
+      continue;
+    }
+
+    // Sleep until tasks are queued; the counter lets submit() skip the
+    // notification while every worker is busy
+    m_sleepingCount.fetch_add(1);
+    std::unique_lock lock{m_sleepMutex};
+    m_wake.wait(lock, [this] {
+      return m_stop || m_queuedTaskCount.load() > 0;
+    });
+    m_sleepingCount.fetch_sub(1);
+    if (m_stop && m_queuedTaskCount.load() == 0) {
+      return;
+    }
+  }
+}
+
+bool WorkStealingExecutor::runPendingTask(const size_t slot) {
+  Task task;
+  if (popOwn(slot, task) || steal(slot, task)) {
+    task();
+    return true;
+  }
+  return false;
+}
+
+bool WorkStealingExecutor::popOwn(const size_t slot, Task& task) {
+  Worker& worker{*m_workers.at(slot)};
+  const std::lock_guard lock{worker.mutex};
+  if (worker.tasks.empty()) {
+    return false;
+  }
+
+  task = std::move(worker.tasks.back());
+  worker.tasks.pop_back();
+  m_queuedTaskCount.fetch_sub(1);
+  return true;
+}
+
+bool WorkStealingExecutor::steal(const size_t slot, Task& task) {
+  const size_t workerCount{m_workers.size()};
+
+  for (size_t offset{1}; offset <= workerCount; ++offset) {
+    const size_t victimSlot{(slot + offset) % workerCount};
+    if (victimSlot == slot) {
+      continue;
+    }
+
+    // Take the oldest half, they are the largest pieces of work left
+    std::vector<Task> stolen;
+    {
+      Worker& victim{*m_workers.at(victimSlot)};
+      const std::lock_guard lock{victim.mutex};
+      if (victim.tasks.empty()) {
+        continue;
+      }
+      const auto stealCount{
+          static_cast<std::ptrdiff_t>((victim.tasks.size() + 1) / 2)};
+      stolen.assign(std::make_move_iterator(victim.tasks.begin()),
+                    std::make_move_iterator(victim.tasks.begin() + stealCount));
+      victim.tasks.erase(victim.tasks.begin(),
+                         victim.tasks.begin() + stealCount);
+      m_queuedTaskCount.fetch_sub(stolen.size());
+    }
+
+    task = std::move(stolen.front());
+    if (stolen.size() > 1) {
+      Worker& own{*m_workers.at(slot)};
+      {
+        const std::lock_guard lock{own.mutex};
+        own.tasks.insert(own.tasks.end(),
+                         std::make_move_iterator(stolen.begin() + 1),
+                         std::make_move_iterator(stolen.end()));
+        m_queuedTaskCount.fetch_add(stolen.size() - 1);
+      }
+      notifySleepers();
+    }
+    return true;
+  }
+  return false;
+}
+
+void WorkStealingExecutor::notifySleepers() {
+  if (m_sleepingCount.load() == 0) {
+    return;
+  }
+  {
+    const std::lock_guard lock{m_sleepMutex};
+  }
+  m_wake.notify_one();
+}
+
+} // namespace tetris
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tetris {
+
+/**
+ * @class WorkStealingExecutor
+ * @brief Thread pool with one task deque per worker
+ *
+ * A worker pushes and pops tasks at the back of its own deque, so nested work
+ * stays on the thread that created it and runs while its data is still in
+ * cache. An idle worker steals half of the oldest tasks of another worker,
+ * which moves large chunks of work with one lock instead of one task at a
+ * time. Each deque has its own mutex; there is no lock shared by all threads.
+ *
+ * A worker waiting in parallelFor() runs queued tasks until its loop is done,
+ * so parallel loops can be nested inside tasks without deadlocking. Any other
+ * thread only runs ranges of the loops it started, so several threads outside
+ * the pool can share one executor.
+ */
+class WorkStealingExecutor {
+public:
+  using Task = std::function<void()>;
+
+  /**
+   * @brief Construct an executor and start its workers
+   *
+   * @param threadCount The number of workers, 0 for one per hardware thread
+   */
+  explicit WorkStealingExecutor(size_t threadCount = 0);
+
+  /**
+   * @brief Stop the workers once their queued tasks are done
+   */
+  ~WorkStealingExecutor();
+
+  WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+  WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+  /**
+   * @brief Get the number of workers
+   */
+  [[nodiscard]] size_t getThreadCount() const { return m_workers.size(); }
+
+  /**
+   * @brief Get the slot of the calling thread
+   *
+   * Workers have slots 0 to getThreadCount() - 1, any other thread has slot
+   * getThreadCount(). Callers can index per-thread scratch data with it: a
+   * worker slot never runs two tasks at once unless a task waits in
+   * parallelFor(), and the shared slot only runs ranges of a loop on the
+   * thread that started it, so scratch data owned by that caller is used by
+   * one thread at a time.
+   *
+   * @return The slot of the calling thread
+   */
+  [[nodiscard]] size_t getCurrentSlot() const;
+
+  /**
+   * @brief Queue a task
+   *
+   * Tasks submitted by a worker go to its own deque, others are spread over
+   * the workers. The task must not throw.
+   *
+   * @param task The task to run
+   */
+  void submit(Task task);
+
+  /**
+   * @brief Run a loop body for every index and wait for all of them
+   *
+   * Indices are grouped into ranges of grainSize consecutive indices, claimed
+   * in order by the calling thread and by queued helper tasks. While the last
+   * ranges finish, a worker runs other queued tasks and any other thread
+   * waits. The first exception thrown by the body is rethrown once every
+   * range has finished.
+   *
+   * @param count The number of indices
+   * @param body Called once with every index in [0, count)
+   * @param grainSize The number of indices per task
+   */
+  void parallelFor(size_t count, const std::function<void(size_t)>& body,
+                   size_t grainSize = 1);
+
+private:
+  /**
+   * @brief The task deque of one worker
+   */
+  struct alignas(64) Worker {
+    std::mutex mutex;       ///< Guards tasks
+    std::deque<Task> tasks; ///< Own tasks at the back, stolen from the front
+  };
+
+  /**
+   * @brief Main loop of a worker thread
+   *
+   * @param slot The slot of the worker
+   */
+  void run(size_t slot);
+
+  /**
+   * @brief Run one queued task, if any
+   *
+   * @param slot The slot of the calling worker
+   * @return true if a task was run
+   */
+  bool runPendingTask(size_t slot);
+
+  /**
+   * @brief Pop the newest task of a worker's own deque
+   *
+   * @param slot The slot of the worker
+   * @param task Output, the task
+   * @return true if a task was popped
+   */
+  bool popOwn(size_t slot, Task& task);
+
+  /**
+   * @brief Steal half of the oldest tasks of another worker
+   *
+   * The thief keeps the stolen tasks but the first in its own deque.
+   *
+   * @param slot The slot of the thief, a worker
+   * @param task Output, the task to run now
+   * @return true if a task was stolen
+   */
+  bool steal(size_t slot, Task& task);
+
+  /**
+   * @brief Wake a sleeping worker after tasks were queued
+   */
+  void notifySleepers();
+
+  std::vector<std::unique_ptr<Worker>> m_workers; ///< Deques, one per worker
+  std::vector<std::thread> m_threads;             ///< Worker threads
+  std::atomic<size_t> m_queuedTaskCount{0};       ///< Tasks in all deques
+  std::atomic<size_t> m_sleepingCount{0};         ///< Workers waiting on m_wake
+  std::atomic<size_t> m_nextWorker{0}; ///< Round-robin for other threads
+  std::mutex m_sleepMutex;             ///< Guards sleeping on m_wake
+  std::condition_variable m_wake;      ///< Signalled when tasks are queued
+  bool m_stop{false};                  ///< Set under m_sleepMutex on exit
+};
+
+} // namespace tetris
@@ -0,0 +1,25 @@
+#include "beam_search_bot.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace tetris {
+
+BeamSearchBot::BeamSearchBot(std::shared_ptr<BeamSearch> search)
+    : m_search{std::move(search)} {
+  [[unlikely]] if (!m_search) {
+    throw std::invalid_argument("BeamSearchBot requires a beam search");
+  }
+}
+
+std::optional<BotMove> BeamSearchBot::decide(const GameState& gameState) {
+  const std::optional<BeamSearch::Result> result{m_search->search(gameState)};
+  if (!result.has_value()) {
+    return std::nullopt;
+  }
+  return BotMove{.piece = result->landing.getPiece().getState(),
+                 .tSpinType = result->landing.getTSpinType(),
+                 .useHold = result->useHold};
+}
+
+} // namespace tetris
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "../search/beam_search.hpp"
+#include "bot.hpp"
+#include <memory>
+
+namespace tetris {
+
+/**
+ * @class BeamSearchBot
+ * @brief Bot placing pieces with a beam search
+ */
+class BeamSearchBot final : public Bot {
+public:
+  /**
+   * @brief Construct a bot
+   *
+   * @param search The beam search choosing placements
+   * @throws std::invalid_argument if search is null
+   */
+  explicit BeamSearchBot(std::shared_ptr<BeamSearch> search);
+
+  /**
+   * @brief Get the name of the bot
+   * @return "BeamSearch"
+   */
+  [[nodiscard]] std::string getName() const override { return "BeamSearch"; }
+
+  /**
+   * @brief Choose the placement of the current piece
+   *
+   * @param gameState The state, with the current piece spawned
+   * @return The placement, or std::nullopt if no piece can be placed
+   */
+  [[nodiscard]] std::optional<BotMove>
+  decide(const GameState& gameState) override;
+
+  /**
+   * @brief Get the beam search
+   */
+  [[nodiscard]] BeamSearch& getSearch() const { return *m_search; }
+
+private:
+  std::shared_ptr<BeamSearch> m_search; ///< Search choosing placements
+};
+
+} // namespace tetris
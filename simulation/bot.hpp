@@ -0,0 +1,57 @@
+#pragma once
+
+#include "../core/game_state.hpp"
+#include "../core/tetris_piece.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace tetris {
+
+/**
+ * @brief A placement chosen by a bot
+ */
+struct BotMove {
+  PieceState piece;     ///< Final state of the placed piece
+  int32_t tSpinType{0}; ///< T-spin type of the placement
+  bool useHold{false};  ///< Whether to hold before placing
+};
+
+/**
+ * @class Bot
+ * @brief Abstract interface for players driven by a simulator
+ *
+ * A bot is asked for a placement once per piece. It returns the final state
+ * of the piece, which the simulator locks directly without replaying the
+ * inputs leading to it.
+ */
+class Bot {
+public:
+  /**
+   * @brief Virtual destructor
+   */
+  virtual ~Bot() = default;
+
+  /**
+   * @brief Get the name of the bot
+   *
+   * @return The name of the bot
+   */
+  [[nodiscard]] virtual std::string getName() const = 0;
+
+  /**
+   * @brief Prepare for a new game, discarding state kept between pieces
+   */
+  virtual void newGame() {}
+
+  /**
+   * @brief Choose the placement of the current piece
+   *
+   * @param gameState The state, with the current piece spawned
+   * @return The placement, or std::nullopt if no piece can be placed
+   */
+  [[nodiscard]] virtual std::optional<BotMove>
+  decide(const GameState& gameState) = 0;
+};
+
+} // namespace tetris
@@ -0,0 +1,217 @@
+#include "replay.hpp"
+#include "../core/piece_queue.hpp"
+#include "../core/tetris_board.hpp"
+
+#include <array>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace tetris {
+
+namespace {
+
+/**
+ * @brief First bytes of the binary form
+ */
+constexpr std::array<uint8_t, 4> replayMagic{'N', 'Z', 'R', 'P'};
+
+/**
+ * @brief Append the low bytes of an integer, least significant first
+ */
+void appendInteger(std::vector<uint8_t>& bytes, const uint64_t value,
+                   const size_t byteCount) {
+  for (size_t i{0}; i < byteCount; ++i) {
+    bytes.push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+/**
+ * @brief Append a name as a length byte and its characters
+ */
+void appendName(std::vector<uint8_t>& bytes, const std::string& name) {
+  appendInteger(bytes, name.size(), 1);
+  bytes.insert(bytes.end(), name.begin(), name.end());
+}
+
+/**
+ * @brief Sequential reader over the binary form
+ */
+class ByteReader {
+public:
+  explicit ByteReader(const std::span<const uint8_t> bytes) : m_bytes{bytes} {}
+
+  /**
+   * @brief Read a little-endian integer
+   *
+   * @throws std::invalid_argument if the bytes run out
+   */
+  uint64_t readInteger(const size_t byteCount) {
+    require(byteCount);
+    uint64_t value{0};
+    for (size_t i{0}; i < byteCount; ++i) {
+      value |= static_cast<uint64_t>(m_bytes[m_offset + i]) << (8 * i);
+    }
+    m_offset += byteCount;
+    return value;
+  }
+
+  /**
+   * @brief Read a name written by appendName()
+   *
+   * @throws std::invalid_argument if the bytes run out
+   */
+  std::string readName() {
+    const auto length{static_cast<size_t>(readInteger(1))};
+    require(length);
+    std::string name(m_bytes.begin() + static_cast<std::ptrdiff_t>(m_offset),
+                     m_bytes.begin() +
+                         static_cast<std::ptrdiff_t>(m_offset + length));
+    m_offset += length;
+    return name;
+  }
+
+  /**
+   * @brief Check that a number of bytes is left
+   *
+   * @throws std::invalid_argument if fewer are left
+   */
+  void require(const size_t byteCount) const {
+    [[unlikely]] if (m_bytes.size() - m_offset < byteCount) {
+      throw std::invalid_argument("Truncated replay");
+    }
+  }
+
+private:
+  std::span<const uint8_t> m_bytes; ///< The binary form
+  size_t m_offset{0};               ///< Bytes read so far
+};
+
+} // namespace
+
+Replay::Replay(Header header) : m_header{std::move(header)} {
+  [[unlikely]] if (m_header.rotationSystem.size() >
+                       std::numeric_limits<uint8_t>::max() ||
+                   m_header.randomizer.size() >
+                       std::numeric_limits<uint8_t>::max()) {
+    throw std::invalid_argument("Replay names are limited to 255 characters");
+  }
+  // Only sizes a game can be played with are accepted, so verifying a
+  // replay never fails on building its board or preview
+  [[unlikely]] if (m_header.width < 4 || m_header.width > maxWidth ||
+                   m_header.height < 4 || m_header.height > maxHeight ||
+                   m_header.previewSize >= PieceQueue::capacity) {
+    throw std::invalid_argument("Replay board or preview size out of range");
+  }
+}
+
+uint32_t Replay::packPlacement(const BotMove& move) {
+  const auto [xPos, yPos] = move.piece.getPosition();
+  [[unlikely]] if (xPos < std::numeric_limits<int8_t>::min() ||
+                   xPos > std::numeric_limits<int8_t>::max() ||
+                   yPos < std::numeric_limits<int8_t>::min() ||
+                   yPos > std::numeric_limits<int8_t>::max() ||
+                   move.tSpinType < 0 || move.tSpinType > 3) {
+    throw std::invalid_argument("Placement does not fit in a replay record");
+  }
+  return static_cast<uint32_t>(std::to_underlying(move.piece.getType())) |
+         (static_cast<uint32_t>(
+              std::to_underlying(move.piece.getRotation()))
+          << 3U) |
+         (static_cast<uint32_t>(move.useHold) << 5U) |
+         (static_cast<uint32_t>(move.tSpinType) << 6U) |
+         (static_cast<uint32_t>(static_cast<uint8_t>(xPos)) << 8U) |
+         (static_cast<uint32_t>(static_cast<uint8_t>(yPos)) << 16U);
+}
+
+void Replay::setFinalState(const GameState& gameState) {
+  m_finalState = FinalState{.hash = gameState.getHash(),
+                            .linesCleared = gameState.getLinesCleared(),
+                            .score = gameState.getScore()};
+}
+
+std::vector<uint8_t> Replay::serialize() const {
+  std::vector<uint8_t> bytes{};
+  bytes.reserve(64 + m_header.rotationSystem.size() +
+                m_header.randomizer.size() +
+                m_placements.size() * placementSize);
+
+  for (const uint8_t byte : replayMagic) {
+    appendInteger(bytes, byte, 1);
+  }
+  appendInteger(bytes, formatVersion, 1);
+  appendInteger(bytes, m_header.seed, 8);
+  appendInteger(bytes, static_cast<uint64_t>(m_header.width), 1);
+  appendInteger(bytes, static_cast<uint64_t>(m_header.height), 1);
+  appendInteger(bytes, m_header.previewSize, 1);
+  appendName(bytes, m_header.rotationSystem);
+  appendName(bytes, m_header.randomizer);
+
+  appendInteger(bytes, m_finalState.hash, 8);
+  appendInteger(bytes, static_cast<uint32_t>(m_finalState.linesCleared), 4);
+  appendInteger(bytes, static_cast<uint64_t>(m_finalState.score), 8);
+
+  appendInteger(bytes, m_placements.size(), 4);
+  for (const uint32_t record : m_placements) {
+    appendInteger(bytes, record, placementSize);
+  }
+  return bytes;
+}
+
+Replay Replay::deserialize(const std::span<const uint8_t> bytes) {
+  ByteReader reader{bytes};
+  for (const uint8_t expected : replayMagic) {
+    [[unlikely]] if (reader.readInteger(1) != expected) {
+      throw std::invalid_argument("Not a replay");
+    }
+  }
+  [[unlikely]] if (reader.readInteger(1) != formatVersion) {
+    throw std::invalid_argument("Unsupported replay version");
+  }
+
+  Header header{};
+  header.seed = reader.readInteger(8);
+  header.width = static_cast<int32_t>(reader.readInteger(1));
+  header.height = static_cast<int32_t>(reader.readInteger(1));
+  header.previewSize = static_cast<size_t>(reader.readInteger(1));
+  header.rotationSystem = reader.readName();
+  header.randomizer = reader.readName();
+  Replay replay{std::move(header)};
+
+  replay.m_finalState.hash = reader.readInteger(8);
+  replay.m_finalState.linesCleared =
+      static_cast<int32_t>(static_cast<uint32_t>(reader.readInteger(4)));
+  replay.m_finalState.score = static_cast<int64_t>(reader.readInteger(8));
+
+  const auto count{static_cast<size_t>(reader.readInteger(4))};
+  reader.require(count * placementSize);
+  replay.m_placements.resize(count);
+  for (uint32_t& record : replay.m_placements) {
+    record = static_cast<uint32_t>(reader.readInteger(placementSize));
+  }
+  return replay;
+}
+
+void Replay::save(const std::string& path) const {
+  const std::vector<uint8_t> bytes{serialize()};
+  std::ofstream file{path, std::ios::binary | std::ios::trunc};
+  file.write(reinterpret_cast<const char*>(bytes.data()),
+             static_cast<std::streamsize>(bytes.size()));
+  [[unlikely]] if (!file) {
+    throw std::runtime_error("Failed to write replay " + path);
+  }
+}
+
+Replay Replay::load(const std::string& path) {
+  std::ifstream file{path, std::ios::binary};
+  [[unlikely]] if (!file) {
+    throw std::runtime_error("Failed to open replay " + path);
+  }
+  const std::vector<uint8_t> bytes{std::istreambuf_iterator<char>{file},
+                                   std::istreambuf_iterator<char>{}};
+  return deserialize(bytes);
+}
+
+} // namespace tetris
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "../core/game_state.hpp"
+#include "bot.hpp"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace tetris {
+
+/**
+ * @class Replay
+ * @brief Compact record of a single-player game
+ *
+ * A replay holds what is needed to play a game again: the seed of the piece
+ * sequence, the names of the rotation system and randomizer, the board and
+ * preview size, and every placement. Placements are final piece states, not
+ * key inputs, packed in 3 bytes each:
+ *
+ * | Bits  | Field                      |
+ * |-------|----------------------------|
+ * | 0-2   | Piece type                 |
+ * | 3-4   | Rotation                   |
+ * | 5     | Hold before placing        |
+ * | 6-7   | T-spin type                |
+ * | 8-15  | x, two's complement        |
+ * | 16-23 | y, two's complement        |
+ *
+ * The hash, lines cleared and score of the final state are stored as well,
+ * so a verifier can confirm the game without trusting the placements.
+ *
+ * The binary form is little-endian: the magic "NZRP", a version byte, the
+ * seed, width, height and preview size, the two names as a length byte and
+ * characters, the final state, the placement count and the placements.
+ */
+class Replay {
+public:
+  /**
+   * @brief Bytes of one packed placement
+   */
+  static constexpr size_t placementSize{3};
+
+  /**
+   * @brief Version of the binary form
+   */
+  static constexpr uint8_t formatVersion{1};
+
+  /**
+   * @brief The rules a game was played with
+   */
+  struct Header {
+    uint64_t seed{0};           ///< Seed of the piece sequence
+    std::string rotationSystem; ///< Name in RuleFactory
+    std::string randomizer;     ///< Name of the randomizer
+    int32_t width{10};          ///< Board width
+    int32_t height{40};         ///< Board height
+    size_t previewSize{5};      ///< Pieces visible after the current one
+  };
+
+  /**
+   * @brief Summary of the state a game ended in
+   */
+  struct FinalState {
+    uint64_t hash{0};        ///< GameState::getHash() of the state
+    int32_t linesCleared{0}; ///< Lines cleared
+    int64_t score{0};        ///< Score
+  };
+
+  /**
+   * @brief Construct an empty replay
+   */
+  Replay() = default;
+
+  /**
+   * @brief Construct a replay of a game about to be played
+   *
+   * @param header The rules of the game
+   * @throws std::invalid_argument if a name is longer than 255 characters,
+   * the board is smaller than 4x4 or larger than maxWidth x maxHeight, or the
+   * preview does not fit in a PieceQueue
+   */
+  explicit Replay(Header header);
+
+  /**
+   * @brief Pack a placement into its 3-byte record
+   *
+   * @throws std::invalid_argument if the position or spin does not fit
+   */
+  [[nodiscard]] static uint32_t packPlacement(const BotMove& move);
+
+  /**
+   * @brief Unpack a record made by packPlacement()
+   */
+  [[nodiscard]] static BotMove unpackPlacement(const uint32_t record) {
+    const auto xPos{static_cast<int8_t>((record >> 8U) & 0xFFU)};
+    const auto yPos{static_cast<int8_t>((record >> 16U) & 0xFFU)};
+    return BotMove{
+        .piece = PieceState{static_cast<PieceType>(record & 0x7U),
+                            Position{xPos, yPos},
+                            static_cast<Rotation>((record >> 3U) & 0x3U)},
+        .tSpinType = static_cast<int32_t>((record >> 6U) & 0x3U),
+        .useHold = ((record >> 5U) & 0x1U) != 0};
+  }
+
+  /**
+   * @brief Append a placement
+   *
+   * @throws std::invalid_argument if the position or spin does not fit
+   */
+  void addPlacement(const BotMove& move) {
+    m_placements.push_back(packPlacement(move));
+  }
+
+  /**
+   * @brief Record the state the game ended in
+   */
+  void setFinalState(const GameState& gameState);
+
+  /**
+   * @brief Record the state the game ended in
+   */
+  void setFinalState(const FinalState& finalState) {
+    m_finalState = finalState;
+  }
+
+  /**
+   * @brief Get the rules of the game
+   */
+  [[nodiscard]] const Header& getHeader() const { return m_header; }
+
+  /**
+   * @brief Get the recorded final state
+   */
+  [[nodiscard]] const FinalState& getFinalState() const {
+    return m_finalState;
+  }
+
+  /**
+   * @brief Get the packed placements, in order
+   */
+  [[nodiscard]] std::span<const uint32_t> getPlacements() const {
+    return m_placements;
+  }
+
+  /**
+   * @brief Get the number of placements
+   */
+  [[nodiscard]] size_t size() const { return m_placements.size(); }
+
+  /**
+   * @brief Encode the replay in its binary form
+   */
+  [[nodiscard]] std::vector<uint8_t> serialize() const;
+
+  /**
+   * @brief Decode a replay from its binary form
+   *
+   * @param bytes The binary form
+   * @return The replay
+   * @throws std::invalid_argument if the bytes are not a replay of this
+   * version, are truncated or hold sizes the constructor rejects
+   */
+  [[nodiscard]] static Replay deserialize(std::span<const uint8_t> bytes);
+
+  /**
+   * @brief Write the binary form to a file
+   *
+   * @throws std::runtime_error if the file cannot be written
+   */
+  void save(const std::string& path) const;
+
+  /**
+   * @brief Read a replay from a file
+   *
+   * @throws std::runtime_error if the file cannot be read
+   * @throws std::invalid_argument if the file is not a replay
+   */
+  [[nodiscard]] static Replay load(const std::string& path);
+
+private:
+  Header m_header;                    ///< Rules of the game
+  FinalState m_finalState;            ///< Recorded final state
+  std::vector<uint32_t> m_placements; ///< Packed placements
+};
+
+} // namespace tetris
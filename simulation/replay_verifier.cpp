@@ -0,0 +1,111 @@
+#include "replay_verifier.hpp"
+#include "../rotation_systems/rule_factory.hpp"
+#include "../search/path_search.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace tetris {
+
+ReplayVerifier::ReplayVerifier(std::shared_ptr<const Randomizer> randomizer,
+                               std::shared_ptr<WorkStealingExecutor> executor)
+    : m_randomizer{std::move(randomizer)}, m_executor{std::move(executor)} {
+  [[unlikely]] if (!m_randomizer) {
+    throw std::invalid_argument("ReplayVerifier requires a randomizer");
+  }
+}
+
+ReplayVerifier::Result ReplayVerifier::verify(const Replay& replay) const {
+  const Replay::Header& header{replay.getHeader()};
+  const auto rotationSystem{
+      RuleFactory::getInstance().createRotationSystem(header.rotationSystem)};
+  if (!rotationSystem) {
+    return Result{.status = ReplayStatus::UnknownRotationSystem};
+  }
+  if (header.randomizer != m_randomizer->getName()) {
+    return Result{.status = ReplayStatus::RandomizerMismatch};
+  }
+
+  const std::shared_ptr<Randomizer> randomizer{m_randomizer->clone()};
+  randomizer->reset(header.seed);
+  GameState gameState{header.width, header.height, rotationSystem};
+  PieceQueue& preview{gameState.getNextPieces()};
+
+  const std::span<const uint32_t> placements{replay.getPlacements()};
+  Result result{};
+  randomizer->fill(preview, header.previewSize);
+  bool alive{gameState.spawnNextPiece()};
+  for (const uint32_t record : placements) {
+    // A game ends when a spawn fails, so no placement may follow one
+    if (!alive) {
+      result.status = ReplayStatus::EarlyEnd;
+      return result;
+    }
+    const BotMove move{Replay::unpackPlacement(record)};
+    randomizer->fill(preview, header.previewSize);
+
+    if (move.useHold) {
+      if (gameState.isHoldUsed()) {
+        result.status = ReplayStatus::IllegalPlacement;
+        return result;
+      }
+      if (!gameState.holdCurrentPiece()) {
+        // The piece swapped in from hold could not spawn
+        alive = false;
+        continue;
+      }
+    }
+
+    PieceState below{move.piece};
+    below.setPosition(move.piece.getPosition() + Position{0, -1});
+    if (move.piece.getType() !=
+            gameState.getCurrentPiece().getState().getType() ||
+        !gameState.isValidState(move.piece) ||
+        gameState.isValidState(below)) {
+      result.status = ReplayStatus::IllegalPlacement;
+      return result;
+    }
+    // A spin must pass the three-corner test in place, as if the piece had
+    // rotated into it last; the path itself is not recorded
+    gameState.getCurrentPiece().setState(move.piece);
+    if (move.tSpinType != 0 &&
+        move.tSpinType != PathSearch::detectTSpin(
+                              gameState, gameState.getCurrentPiece(), true)) {
+      result.status = ReplayStatus::IllegalPlacement;
+      return result;
+    }
+    gameState.lockCurrentPiece(move.tSpinType);
+    ++result.placements;
+
+    randomizer->fill(preview, header.previewSize);
+    alive = gameState.spawnNextPiece();
+  }
+
+  // Simulator tops the preview up when a game ends, however it ended
+  randomizer->fill(preview, header.previewSize);
+  const Replay::FinalState& expected{replay.getFinalState()};
+  if (gameState.getHash() != expected.hash ||
+      gameState.getLinesCleared() != expected.linesCleared ||
+      gameState.getScore() != expected.score) {
+    result.status = ReplayStatus::FinalStateMismatch;
+  }
+  return result;
+}
+
+std::vector<ReplayVerifier::Result>
+ReplayVerifier::verify(const std::span<const Replay> replays) const {
+  std::vector<Result> results(replays.size());
+  const auto check{[&](const size_t index) {
+    results[index] = verify(replays[index]);
+  }};
+  if (m_executor) {
+    m_executor->parallelFor(replays.size(), check);
+  } else {
+    for (size_t index{0}; index < replays.size(); ++index) {
+      check(index);
+    }
+  }
+  return results;
+}
+
+} // namespace tetris
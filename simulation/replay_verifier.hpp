@@ -0,0 +1,88 @@
+#pragma once
+
+#include "../randomizers/randomizer.hpp"
+#include "../search/work_stealing_executor.hpp"
+#include "replay.hpp"
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace tetris {
+
+/**
+ * @brief Outcome of verifying a replay
+ */
+enum class ReplayStatus {
+  Valid,                 ///< Every placement is legal and the state matches
+  UnknownRotationSystem, ///< The rotation system is not in RuleFactory
+  RandomizerMismatch,    ///< The replay names another randomizer
+  IllegalPlacement,      ///< A placement collides, floats, is not current
+                         ///< or claims a spin it is not in
+  EarlyEnd,              ///< The game ended before the last placement
+  FinalStateMismatch,    ///< The final hash, lines or score differ
+};
+
+/**
+ * @class ReplayVerifier
+ * @brief Plays replays again through GameState and checks their final state
+ *
+ * The piece sequence is dealt again from the seed, topping up the preview
+ * exactly as Simulator does, and every placement is checked and locked
+ * directly in its final state. A placement must be of the current piece, or
+ * of the piece swapped in by hold, fit on the board and rest on the stack or
+ * the floor; whether it can be reached from spawn is not checked. A claimed
+ * T-spin must be a T piece whose corners give that spin type, since spins
+ * feed the score, combo and back-to-back. The state after the last placement
+ * must match the recorded hash, lines cleared and score.
+ *
+ * Nothing is allocated per placement, so a verifier checks placements at
+ * the rate GameState can lock them. Batches of replays are checked in
+ * parallel on an executor.
+ */
+class ReplayVerifier {
+public:
+  /**
+   * @brief The outcome of one replay
+   */
+  struct Result {
+    ReplayStatus status{ReplayStatus::Valid}; ///< Outcome
+    size_t placements{0};                     ///< Placements locked
+  };
+
+  /**
+   * @brief Construct a verifier
+   *
+   * @param randomizer The randomizer the replays were dealt by
+   * @param executor The executor checking batches, null to check them on the
+   * calling thread
+   * @throws std::invalid_argument if randomizer is null
+   */
+  explicit ReplayVerifier(
+      std::shared_ptr<const Randomizer> randomizer,
+      std::shared_ptr<WorkStealingExecutor> executor = nullptr);
+
+  /**
+   * @brief Verify one replay
+   *
+   * @param replay The replay
+   * @return The outcome, with the number of placements locked before it was
+   * decided
+   */
+  [[nodiscard]] Result verify(const Replay& replay) const;
+
+  /**
+   * @brief Verify several replays
+   *
+   * @param replays The replays
+   * @return The outcome of every replay, in order
+   */
+  [[nodiscard]] std::vector<Result>
+  verify(std::span<const Replay> replays) const;
+
+private:
+  std::shared_ptr<const Randomizer> m_randomizer;   ///< Randomizer prototype
+  std::shared_ptr<WorkStealingExecutor> m_executor; ///< Batch executor
+};
+
+} // namespace tetris
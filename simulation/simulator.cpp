@@ -0,0 +1,130 @@
+#include "simulator.hpp"
+#include "../core/zobrist.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+namespace tetris {
+
+Simulator::Simulator(std::shared_ptr<RotationSystem> rotationSystem,
+                     std::shared_ptr<Randomizer> randomizer)
+    : Simulator{std::move(rotationSystem), std::move(randomizer), Config{}} {}
+
+Simulator::Simulator(std::shared_ptr<RotationSystem> rotationSystem,
+                     std::shared_ptr<Randomizer> randomizer,
+                     const Config& config)
+    : m_rotationSystem{std::move(rotationSystem)},
+      m_randomizer{std::move(randomizer)}, m_config{config},
+      m_gameState{config.width, config.height, m_rotationSystem} {
+  [[unlikely]] if (!m_rotationSystem || !m_randomizer) {
+    throw std::invalid_argument(
+        "Simulator requires a rotation system and a randomizer");
+  }
+  [[unlikely]] if (m_config.previewSize >= PieceQueue::capacity) {
+    throw std::invalid_argument("Preview size exceeds the piece queue");
+  }
+}
+
+Simulator::GameResult Simulator::playGame(Bot& bot, const uint64_t seed,
+                                          Replay* replay) {
+  m_gameState = GameState{m_config.width, m_config.height, m_rotationSystem};
+  m_randomizer->reset(seed);
+  bot.newGame();
+  if (replay != nullptr) {
+    *replay = Replay{Replay::Header{
+        .seed = seed,
+        .rotationSystem = m_rotationSystem->getName(),
+        .randomizer = m_randomizer->getName(),
+        .width = m_config.width,
+        .height = m_config.height,
+        .previewSize = m_config.previewSize}};
+  }
+
+  GameResult result{.seed = seed};
+  fillPreview();
+  if (!m_gameState.spawnNextPiece()) {
+    result.toppedOut = true;
+    fillPreview();
+    if (replay != nullptr) {
+      replay->setFinalState(m_gameState);
+    }
+    return result;
+  }
+
+  while (m_config.maxPieces == 0 || result.pieces < m_config.maxPieces) {
+    fillPreview();
+    const std::optional<BotMove> move{bot.decide(m_gameState)};
+    if (!move.has_value()) {
+      result.toppedOut = true;
+      break;
+    }
+
+    if (replay != nullptr) {
+      replay->addPlacement(*move);
+    }
+    if (!placeMove(m_gameState, *move)) {
+      result.toppedOut = true;
+      break;
+    }
+    ++result.pieces;
+
+    fillPreview();
+    if (!m_gameState.spawnNextPiece()) {
+      result.toppedOut = true;
+      break;
+    }
+  }
+
+  result.linesCleared = m_gameState.getLinesCleared();
+  // The game ends with a full preview whatever ended it, so the final state
+  // of a replay does not depend on why the game stopped
+  fillPreview();
+  if (replay != nullptr) {
+    replay->setFinalState(m_gameState);
+  }
+  return result;
+}
+
+bool Simulator::placeMove(GameState& gameState, const BotMove& move) {
+  if (move.useHold) {
+    [[unlikely]] if (gameState.isHoldUsed()) {
+      throw std::invalid_argument("Bot held twice in one turn");
+    }
+    if (!gameState.holdCurrentPiece()) {
+      // The piece swapped in from hold could not spawn
+      return false;
+    }
+  }
+
+  // The piece must rest on the stack or the floor, as ReplayVerifier checks
+  PieceState below{move.piece};
+  below.setPosition(move.piece.getPosition() + Position{0, -1});
+  [[unlikely]] if (move.piece.getType() !=
+                       gameState.getCurrentPiece().getState().getType() ||
+                   !gameState.isValidState(move.piece) ||
+                   gameState.isValidState(below)) {
+    throw std::invalid_argument("Bot chose an invalid placement");
+  }
+  gameState.getCurrentPiece().setState(move.piece);
+  gameState.lockCurrentPiece(move.tSpinType);
+  return true;
+}
+
+Simulator::Stats Simulator::run(Bot& bot, const size_t games, uint64_t seed) {
+  Stats stats{};
+  const auto start{std::chrono::steady_clock::now()};
+  for (size_t game{0}; game < games; ++game) {
+    const GameResult result{playGame(bot, splitMix64(seed))};
+    ++stats.games;
+    stats.pieces += result.pieces;
+    stats.linesCleared += result.linesCleared;
+    stats.topOuts += result.toppedOut ? 1 : 0;
+  }
+  stats.seconds = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  return stats;
+}
+
+} // namespace tetris
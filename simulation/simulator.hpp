@@ -0,0 +1,158 @@
+#pragma once
+
+#include "../core/game_state.hpp"
+#include "../randomizers/randomizer.hpp"
+#include "../rotation_systems/rotation_system.hpp"
+#include "bot.hpp"
+#include "replay.hpp"
+#include <cstdint>
+#include <memory>
+
+namespace tetris {
+
+/**
+ * @class Simulator
+ * @brief Headless driver playing whole games with a bot
+ *
+ * Each turn the preview is topped up from the randomizer, the bot chooses a
+ * placement and the piece is put in its final state and locked, without
+ * replaying moves through GameState::applyMove(). A game ends when a piece
+ * cannot spawn, the bot finds no placement or the piece limit is reached,
+ * and in every case it ends with the preview topped up.
+ *
+ * The game state is reused from game to game and the preview is an inline
+ * queue, so the simulator allocates nothing per piece; whatever the bot
+ * allocates is its own.
+ */
+class Simulator {
+public:
+  /**
+   * @brief Configuration options for the simulator
+   */
+  struct Config {
+    int32_t width{10};       ///< Board width
+    int32_t height{40};      ///< Board height
+    size_t previewSize{5};   ///< Pieces visible after the current one
+    size_t maxPieces{10000}; ///< Pieces after which a game stops, 0 none
+  };
+
+  /**
+   * @brief The outcome of one game
+   */
+  struct GameResult {
+    uint64_t seed{0};        ///< Seed of the piece sequence
+    size_t pieces{0};        ///< Pieces placed
+    int32_t linesCleared{0}; ///< Lines cleared
+    bool toppedOut{false};   ///< Whether the game ended by topping out
+  };
+
+  /**
+   * @brief Totals over several games
+   */
+  struct Stats {
+    size_t games{0};         ///< Games played
+    size_t pieces{0};        ///< Pieces placed
+    int64_t linesCleared{0}; ///< Lines cleared
+    size_t topOuts{0};       ///< Games ended by topping out
+    double seconds{0.0};     ///< Wall-clock time spent
+
+    /**
+     * @brief Get the number of pieces placed per second
+     */
+    [[nodiscard]] double getPiecesPerSecond() const {
+      return seconds > 0.0 ? static_cast<double>(pieces) / seconds : 0.0;
+    }
+
+    /**
+     * @brief Get the number of games played per second
+     */
+    [[nodiscard]] double getGamesPerSecond() const {
+      return seconds > 0.0 ? static_cast<double>(games) / seconds : 0.0;
+    }
+  };
+
+  /**
+   * @brief Construct a simulator with the default configuration
+   *
+   * @param rotationSystem The rotation system of the games
+   * @param randomizer The randomizer dealing the pieces
+   * @throws std::invalid_argument if rotationSystem or randomizer is null
+   */
+  Simulator(std::shared_ptr<RotationSystem> rotationSystem,
+            std::shared_ptr<Randomizer> randomizer);
+
+  /**
+   * @brief Construct a simulator
+   *
+   * @param rotationSystem The rotation system of the games
+   * @param randomizer The randomizer dealing the pieces
+   * @param config The simulator configuration
+   * @throws std::invalid_argument if rotationSystem or randomizer is null, or
+   * previewSize does not fit in a PieceQueue
+   */
+  Simulator(std::shared_ptr<RotationSystem> rotationSystem,
+            std::shared_ptr<Randomizer> randomizer, const Config& config);
+
+  /**
+   * @brief Play one game
+   *
+   * @param bot The player
+   * @param seed The seed of the piece sequence
+   * @param replay Output, the replay of the game, or null to record none
+   * @return The outcome of the game
+   * @throws std::invalid_argument if the bot chooses a placement that is not
+   * of the current piece, collides, floats above the stack, or holds when
+   * hold is unavailable
+   */
+  GameResult playGame(Bot& bot, uint64_t seed, Replay* replay = nullptr);
+
+  /**
+   * @brief Play several games
+   *
+   * The seed of each game is derived from the given seed, so a run is
+   * reproducible.
+   *
+   * @param bot The player
+   * @param games The number of games
+   * @param seed The seed of the run
+   * @return The totals over the games
+   */
+  Stats run(Bot& bot, size_t games, uint64_t seed);
+
+  /**
+   * @brief Hold if the move asks to, then lock the current piece in its
+   * final state
+   *
+   * @param gameState The state, with the current piece spawned
+   * @param move The move of the bot
+   * @return false if the piece swapped in from hold could not spawn
+   * @throws std::invalid_argument if the move is not of the current piece,
+   * collides, floats above the stack, or holds when hold is unavailable
+   */
+  static bool placeMove(GameState& gameState, const BotMove& move);
+
+  /**
+   * @brief Get the state at the end of the last game
+   */
+  [[nodiscard]] const GameState& getGameState() const { return m_gameState; }
+
+  /**
+   * @brief Get the configuration options
+   */
+  [[nodiscard]] const Config& getConfig() const { return m_config; }
+
+private:
+  /**
+   * @brief Top up the preview from the randomizer
+   */
+  void fillPreview() {
+    m_randomizer->fill(m_gameState.getNextPieces(), m_config.previewSize);
+  }
+
+  std::shared_ptr<RotationSystem> m_rotationSystem; ///< Rotation system
+  std::shared_ptr<Randomizer> m_randomizer;         ///< Piece randomizer
+  Config m_config;                                  ///< Simulator configuration
+  GameState m_gameState;                            ///< State of the game
+};
+
+} // namespace tetris
@@ -0,0 +1,181 @@
+#include "sprt_runner.hpp"
+#include "../core/zobrist.hpp"
+#include "../randomizers/bag_randomizer.hpp"
+#include "../rotation_systems/rule_factory.hpp"
+#include "../search/search_factory.hpp"
+#include "beam_search_bot.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace tetris {
+
+namespace {
+
+/**
+ * @brief Expected score of a player stronger by an Elo difference
+ */
+double getExpectedScore(const double elo) {
+  return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+/**
+ * @brief Elo difference of an expected score
+ */
+double getEloDifference(const double score) {
+  const double clamped{std::clamp(score, 1e-6, 1.0 - 1e-6)};
+  return -400.0 * std::log10(1.0 / clamped - 1.0);
+}
+
+} // namespace
+
+SprtRunner::SprtRunner(const BotConfig& botA, const BotConfig& botB,
+                       const Config& config,
+                       std::shared_ptr<WorkStealingExecutor> executor)
+    : m_config{config}, m_executor{std::move(executor)} {
+  [[unlikely]] if (m_config.alpha <= 0.0 || m_config.alpha >= 1.0 ||
+                   m_config.beta <= 0.0 || m_config.beta >= 1.0 ||
+                   m_config.elo1 <= m_config.elo0 ||
+                   m_config.batchPairs == 0) {
+    throw std::invalid_argument("Invalid SPRT parameters");
+  }
+
+  auto rotationSystem{RuleFactory::getInstance().createRotationSystem(
+      m_config.rotationSystem)};
+  [[unlikely]] if (!rotationSystem) {
+    throw std::invalid_argument("Unknown rotation system: " +
+                                m_config.rotationSystem);
+  }
+  const AttackTable& attackTable{m_config.match.attackTable};
+  VersusSimulator::BotFactory factoryA{makeBotFactory(botA, attackTable)};
+  VersusSimulator::BotFactory factoryB{makeBotFactory(botB, attackTable)};
+
+  const auto randomizer{std::make_shared<BagRandomizer>()};
+  m_aFirst = std::make_unique<VersusSimulator>(
+      rotationSystem, randomizer, factoryA, factoryB, m_config.match);
+  m_bFirst = std::make_unique<VersusSimulator>(
+      rotationSystem, randomizer, factoryB, factoryA, m_config.match);
+}
+
+SprtRunner::Report SprtRunner::run() const {
+  const auto start{std::chrono::steady_clock::now()};
+  uint64_t seedState{m_config.seed};
+  size_t wins{0};
+  size_t draws{0};
+  size_t losses{0};
+  Report report{evaluate(0, 0, 0)};
+
+  std::vector<uint64_t> seeds{};
+  std::vector<VersusSimulator::MatchResult> results{};
+  for (size_t pairs{0}; pairs < m_config.maxPairs;) {
+    const size_t batch{
+        std::min(m_config.batchPairs, m_config.maxPairs - pairs)};
+    seeds.resize(batch);
+    for (uint64_t& seed : seeds) {
+      seed = splitMix64(seedState);
+    }
+
+    // Even indices play A first, odd ones the same seed with B first
+    results.assign(batch * 2, VersusSimulator::MatchResult{});
+    const auto play{[&](const size_t index) {
+      const uint64_t seed{seeds.at(index / 2)};
+      results.at(index) = index % 2 == 0 ? m_aFirst->playMatch(seed)
+                                         : m_bFirst->playMatch(seed);
+    }};
+    if (m_executor) {
+      m_executor->parallelFor(results.size(), play);
+    } else {
+      for (size_t index{0}; index < results.size(); ++index) {
+        play(index);
+      }
+    }
+
+    for (size_t index{0}; index < results.size(); ++index) {
+      const int32_t sideA{index % 2 == 0 ? 0 : 1};
+      const int32_t winner{results.at(index).winner};
+      wins += winner == sideA ? 1 : 0;
+      draws += winner < 0 ? 1 : 0;
+      losses += winner >= 0 && winner != sideA ? 1 : 0;
+    }
+    pairs += batch;
+
+    report = evaluate(wins, draws, losses);
+    if (report.decision != SprtDecision::Inconclusive) {
+      break;
+    }
+  }
+
+  report.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return report;
+}
+
+SprtRunner::Report SprtRunner::evaluate(const size_t wins, const size_t draws,
+                                        const size_t losses) const {
+  Report report{.matches = wins + draws + losses,
+                .wins = wins,
+                .draws = draws,
+                .losses = losses,
+                .lowerBound = std::log(m_config.beta / (1.0 - m_config.alpha)),
+                .upperBound =
+                    std::log((1.0 - m_config.beta) / m_config.alpha)};
+  if (report.matches == 0) {
+    return report;
+  }
+
+  const auto count{static_cast<double>(report.matches)};
+  const double winRate{static_cast<double>(wins) / count};
+  const double drawRate{static_cast<double>(draws) / count};
+  const double lossRate{static_cast<double>(losses) / count};
+  const double score{winRate + 0.5 * drawRate};
+  const double variance{winRate * (1.0 - score) * (1.0 - score) +
+                        drawRate * (0.5 - score) * (0.5 - score) +
+                        lossRate * score * score};
+
+  const double margin{1.96 * std::sqrt(variance / count)};
+  report.elo = getEloDifference(score);
+  report.eloLower = getEloDifference(score - margin);
+  report.eloUpper = getEloDifference(score + margin);
+
+  // Identical outcomes carry no variance; wait for a differing one
+  if (variance <= 0.0) {
+    return report;
+  }
+  const double score0{getExpectedScore(m_config.elo0)};
+  const double score1{getExpectedScore(m_config.elo1)};
+  report.llr = count * (score1 - score0) * (2.0 * score - score0 - score1) /
+               (2.0 * variance);
+  if (report.llr >= report.upperBound) {
+    report.decision = SprtDecision::AcceptH1;
+  } else if (report.llr <= report.lowerBound) {
+    report.decision = SprtDecision::AcceptH0;
+  }
+  return report;
+}
+
+VersusSimulator::BotFactory
+SprtRunner::makeBotFactory(const BotConfig& botConfig,
+                           const AttackTable& attackTable) {
+  std::shared_ptr<const SearchAlgorithm> movegen{
+      SearchFactory::getInstance().createSearchAlgorithm(botConfig.movegen)};
+  [[unlikely]] if (!movegen) {
+    throw std::invalid_argument("Unknown move generator: " +
+                                botConfig.movegen);
+  }
+  auto evaluator{std::make_shared<const LinearEvaluator>(botConfig.weights)};
+
+  // Move generation and evaluation are shared read-only; every bot gets its
+  // own search
+  return [movegen = std::move(movegen), evaluator = std::move(evaluator),
+          attackTable, searchConfig = botConfig.search] {
+    return std::make_shared<BeamSearchBot>(std::make_shared<BeamSearch>(
+        movegen, evaluator, attackTable, searchConfig));
+  };
+}
+
+} // namespace tetris
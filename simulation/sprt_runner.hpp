@@ -0,0 +1,136 @@
+#pragma once
+
+#include "../evaluation/linear_evaluator.hpp"
+#include "../search/beam_search.hpp"
+#include "../search/work_stealing_executor.hpp"
+#include "versus_simulator.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace tetris {
+
+/**
+ * @brief Outcome of a sequential probability ratio test
+ */
+enum class SprtDecision {
+  Inconclusive, ///< The match limit was reached before a bound
+  AcceptH0,     ///< The difference is at most elo0
+  AcceptH1,     ///< The difference is at least elo1
+};
+
+/**
+ * @class SprtRunner
+ * @brief Plays two bot configurations against each other until a sequential
+ * probability ratio test decides
+ *
+ * Configuration A plays B on pairs of matches with the same seed and swapped
+ * sides, so neither gains from moving first or from a lucky sequence. Pairs
+ * run in batches on an executor and the test is checked after every batch.
+ *
+ * The log-likelihood ratio uses the normal approximation of the trinomial
+ * test: with mean score m and per-match score variance v over N matches,
+ * LLR = N (s1 - s0) (2m - s0 - s1) / (2v), where s0 and s1 are the expected
+ * scores of elo0 and elo1. The test stops when the ratio leaves
+ * [log(beta / (1 - alpha)), log((1 - beta) / alpha)].
+ */
+class SprtRunner {
+public:
+  /**
+   * @brief A bot configuration, built from factory names
+   */
+  struct BotConfig {
+    std::string movegen{"PathSearch"}; ///< Name in SearchFactory
+    BeamSearch::Config search;         ///< Beam search configuration
+    LinearEvaluator::Weights weights{
+        LinearEvaluator::defaultWeights}; ///< Evaluator weights
+  };
+
+  /**
+   * @brief Configuration options of the test
+   */
+  struct Config {
+    std::string rotationSystem{"SRS"}; ///< Name in RuleFactory
+    VersusSimulator::Config match;     ///< Rules of every match
+    double elo0{0.0};                  ///< Elo difference of H0
+    double elo1{5.0};                  ///< Elo difference of H1
+    double alpha{0.05};                ///< False positive rate
+    double beta{0.05};                 ///< False negative rate
+    size_t batchPairs{32};             ///< Match pairs between checks
+    size_t maxPairs{10000};            ///< Match pairs before giving up
+    uint64_t seed{0};                  ///< Seed of the match seeds
+  };
+
+  /**
+   * @brief The state of the test, from the point of view of A
+   */
+  struct Report {
+    size_t matches{0};                                ///< Matches played
+    size_t wins{0};                                   ///< Matches won by A
+    size_t draws{0};                                  ///< Drawn matches
+    size_t losses{0};                                 ///< Matches lost by A
+    double llr{0.0};                                  ///< Log-likelihood ratio
+    double lowerBound{0.0};                           ///< LLR accepting H0
+    double upperBound{0.0};                           ///< LLR accepting H1
+    double elo{0.0};                                  ///< Estimated difference
+    double eloLower{0.0};                             ///< Lower 95% bound
+    double eloUpper{0.0};                             ///< Upper 95% bound
+    SprtDecision decision{SprtDecision::Inconclusive}; ///< Outcome
+    double seconds{0.0};                              ///< Wall-clock time spent
+  };
+
+  /**
+   * @brief Construct a runner
+   *
+   * @param botA The configuration under test
+   * @param botB The reference configuration
+   * @param config The test configuration
+   * @param executor The executor running matches, null to run them on the
+   * calling thread
+   * @throws std::invalid_argument if a factory name is not registered, or
+   * the test parameters are out of range
+   */
+  SprtRunner(const BotConfig& botA, const BotConfig& botB,
+             const Config& config,
+             std::shared_ptr<WorkStealingExecutor> executor = nullptr);
+
+  /**
+   * @brief Play matches until the test decides or the limit is reached
+   *
+   * @return The final state of the test
+   */
+  [[nodiscard]] Report run() const;
+
+  /**
+   * @brief Compute the test state from match counts
+   *
+   * @param wins Matches won by A
+   * @param draws Drawn matches
+   * @param losses Matches lost by A
+   * @return The report; decision is AcceptH0 or AcceptH1 once a bound is
+   * crossed
+   */
+  [[nodiscard]] Report evaluate(size_t wins, size_t draws,
+                                size_t losses) const;
+
+  /**
+   * @brief Get the configuration options
+   */
+  [[nodiscard]] const Config& getConfig() const { return m_config; }
+
+private:
+  /**
+   * @brief Make the factory of the bots of a configuration
+   *
+   * @throws std::invalid_argument if the move generator is not registered
+   */
+  [[nodiscard]] static VersusSimulator::BotFactory
+  makeBotFactory(const BotConfig& botConfig, const AttackTable& attackTable);
+
+  Config m_config;                                  ///< Test configuration
+  std::unique_ptr<VersusSimulator> m_aFirst;        ///< Matches, A moving first
+  std::unique_ptr<VersusSimulator> m_bFirst;        ///< Matches, B moving first
+  std::shared_ptr<WorkStealingExecutor> m_executor; ///< Match executor
+};
+
+} // namespace tetris
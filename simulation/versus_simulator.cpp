@@ -0,0 +1,221 @@
+#include "versus_simulator.hpp"
+#include "../core/zobrist.hpp"
+#include "simulator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+namespace tetris {
+
+namespace {
+
+/**
+ * @brief Garbage sent but not yet allowed to land
+ */
+struct PendingGarbage {
+  GarbageBatch batch;   ///< The garbage rows
+  size_t readyPiece{0}; ///< Receiver piece count from which it may land
+};
+
+/**
+ * @brief One side of a match
+ */
+struct Player {
+  /**
+   * @brief Construct a player with an empty game
+   */
+  explicit Player(GameState initialState)
+      : gameState{std::move(initialState)} {}
+
+  GameState gameState;                    ///< State of the player's game
+  std::shared_ptr<Randomizer> randomizer; ///< Randomizer of the player
+  std::shared_ptr<Bot> bot;               ///< The player
+  std::vector<PendingGarbage> incoming;   ///< Garbage on its way, oldest first
+};
+
+/**
+ * @brief Spend attack on garbage that is on its way, oldest first
+ *
+ * @return The attack left
+ */
+int32_t cancelPending(std::vector<PendingGarbage>& incoming, int32_t attack) {
+  size_t emptied{0};
+  for (PendingGarbage& pending : incoming) {
+    if (attack == 0) {
+      break;
+    }
+    const int32_t cancelled{std::min(attack, pending.batch.lines)};
+    pending.batch.lines -= cancelled;
+    attack -= cancelled;
+    emptied += pending.batch.lines == 0 ? 1 : 0;
+  }
+  incoming.erase(incoming.begin(),
+                 incoming.begin() + static_cast<std::ptrdiff_t>(emptied));
+  return attack;
+}
+
+} // namespace
+
+VersusSimulator::VersusSimulator(
+    std::shared_ptr<RotationSystem> rotationSystem,
+    std::shared_ptr<Randomizer> randomizer, BotFactory firstBot,
+    BotFactory secondBot, const Config& config,
+    std::shared_ptr<WorkStealingExecutor> executor)
+    : m_rotationSystem{std::move(rotationSystem)},
+      m_randomizer{std::move(randomizer)},
+      m_botFactories{std::move(firstBot), std::move(secondBot)},
+      m_config{config}, m_executor{std::move(executor)} {
+  [[unlikely]] if (!m_rotationSystem || !m_randomizer ||
+                   !m_botFactories.at(0) || !m_botFactories.at(1)) {
+    throw std::invalid_argument(
+        "VersusSimulator requires a rotation system, a randomizer and bots");
+  }
+  [[unlikely]] if (m_config.previewSize >= PieceQueue::capacity) {
+    throw std::invalid_argument("Preview size exceeds the piece queue");
+  }
+  [[unlikely]] if (m_config.garbageCap <= 0) {
+    throw std::invalid_argument("Garbage cap must be positive");
+  }
+}
+
+VersusSimulator::MatchResult
+VersusSimulator::playMatch(const uint64_t seed) const {
+  const GameState emptyState{m_config.width, m_config.height,
+                             m_rotationSystem};
+  std::array<Player, 2> players{Player{emptyState}, Player{emptyState}};
+  for (size_t side{0}; side < players.size(); ++side) {
+    Player& player{players.at(side)};
+    player.randomizer = m_randomizer->clone();
+    player.randomizer->reset(seed);
+    player.bot = m_botFactories.at(side)();
+    [[unlikely]] if (!player.bot) {
+      throw std::invalid_argument("Bot factory returned no bot");
+    }
+    player.bot->newGame();
+  }
+
+  // Holes come from their own stream, so both players see the same pieces
+  uint64_t holeState{seed ^ 0x6A5BA6EULL};
+  MatchResult result{.seed = seed};
+  const auto spawn{[&](Player& player) {
+    player.randomizer->fill(player.gameState.getNextPieces(),
+                            m_config.previewSize);
+    return player.gameState.spawnNextPiece();
+  }};
+  for (size_t side{0}; side < players.size(); ++side) {
+    if (!spawn(players.at(side))) {
+      result.winner = static_cast<int32_t>(1 - side);
+      return result;
+    }
+  }
+
+  while (result.pieces.at(1) < m_config.maxPieces) {
+    for (size_t side{0}; side < players.size(); ++side) {
+      Player& player{players.at(side)};
+      Player& opponent{players.at(1 - side)};
+      GameState& gameState{player.gameState};
+      size_t& pieces{result.pieces.at(side)};
+
+      // Garbage that waited long enough joins the player's queue; while that
+      // queue is full, as on a long combo, the rest keeps waiting here
+      size_t landed{0};
+      while (landed < player.incoming.size() &&
+             player.incoming.at(landed).readyPiece <= pieces &&
+             gameState.getGarbageQueue().size() < GarbageQueue::capacity) {
+        const GarbageBatch& batch{player.incoming.at(landed++).batch};
+        gameState.queueGarbage(batch.lines, batch.holeColumn);
+      }
+      player.incoming.erase(player.incoming.begin(),
+                            player.incoming.begin() +
+                                static_cast<std::ptrdiff_t>(landed));
+
+      player.randomizer->fill(gameState.getNextPieces(), m_config.previewSize);
+      const std::optional<BotMove> move{player.bot->decide(gameState)};
+      const int32_t combo{gameState.getCombo()};
+      const bool backToBack{gameState.isBackToBack()};
+      if (!move.has_value() || !Simulator::placeMove(gameState, *move)) {
+        result.winner = static_cast<int32_t>(1 - side);
+        break;
+      }
+      ++pieces;
+
+      const PlacementResult& placement{gameState.getLastPlacement()};
+      int32_t attack{m_config.attackTable
+                         .computeAttack(placement, combo, backToBack)
+                         .attack};
+      if (m_config.cancelGarbage) {
+        attack =
+            cancelPending(player.incoming, gameState.cancelGarbage(attack));
+      }
+      if (attack > 0) {
+        const GarbageBatch batch{
+            .lines = attack,
+            .holeColumn = static_cast<int32_t>(drawBelow(
+                holeState, static_cast<uint32_t>(m_config.width)))};
+        opponent.incoming.push_back(PendingGarbage{
+            .batch = batch,
+            .readyPiece = result.pieces.at(1 - side) +
+                          static_cast<size_t>(
+                              std::max(m_config.garbageDelay, 0))});
+        result.attack.at(side) += attack;
+      }
+
+      if (placement.linesCleared == 0) {
+        gameState.receiveGarbage(m_config.garbageCap);
+      }
+      if (gameState.isGameOver() || !spawn(player)) {
+        result.winner = static_cast<int32_t>(1 - side);
+        break;
+      }
+    }
+    if (result.winner >= 0) {
+      break;
+    }
+  }
+
+  for (size_t side{0}; side < players.size(); ++side) {
+    result.linesCleared.at(side) = players.at(side).gameState.getLinesCleared();
+  }
+  return result;
+}
+
+std::vector<VersusSimulator::MatchResult>
+VersusSimulator::playMatches(const std::span<const uint64_t> seeds) const {
+  std::vector<MatchResult> results(seeds.size());
+  const auto play{[&](const size_t index) {
+    results.at(index) = playMatch(seeds[index]);
+  }};
+  if (m_executor) {
+    m_executor->parallelFor(seeds.size(), play);
+  } else {
+    for (size_t index{0}; index < seeds.size(); ++index) {
+      play(index);
+    }
+  }
+  return results;
+}
+
+VersusSimulator::Stats
+VersusSimulator::run(const std::span<const uint64_t> seeds) const {
+  const auto start{std::chrono::steady_clock::now()};
+  const std::vector<MatchResult> results{playMatches(seeds)};
+
+  Stats stats{};
+  for (const MatchResult& result : results) {
+    ++stats.matches;
+    if (result.winner < 0) {
+      ++stats.draws;
+    } else {
+      ++stats.wins.at(static_cast<size_t>(result.winner));
+    }
+    stats.pieces += result.pieces.at(0) + result.pieces.at(1);
+  }
+  stats.seconds = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  return stats;
+}
+
+} // namespace tetris
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "../core/attack_table.hpp"
+#include "../core/game_state.hpp"
+#include "../randomizers/randomizer.hpp"
+#include "../rotation_systems/rotation_system.hpp"
+#include "../search/work_stealing_executor.hpp"
+#include "bot.hpp"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace tetris {
+
+/**
+ * @class VersusSimulator
+ * @brief Headless two-player matches exchanging garbage
+ *
+ * The players take turns placing one piece each, the first player moving
+ * first, and both are dealt the same piece sequence. The attack of a
+ * placement, from the attack table, first cancels garbage waiting for the
+ * attacker and the rest is sent as one batch with a random hole column. Sent
+ * garbage waits a number of the receiver's placements before it can be
+ * inserted, and is then inserted after the receiver's next placement that
+ * clears no lines, up to a cap per placement. Ready batches that do not fit
+ * in the receiver's garbage queue keep waiting until it has room. A player
+ * loses when a piece cannot spawn, garbage pushes cells past the top or the
+ * bot finds no move.
+ *
+ * A match is determined by its seed, so the results of a seed list do not
+ * depend on the number of threads. Matches run in parallel on an executor;
+ * each match builds its own bots and randomizers, so bots need not be
+ * thread-safe but their factories must be.
+ */
+class VersusSimulator {
+public:
+  /**
+   * @brief Creates a fresh bot for one match
+   */
+  using BotFactory = std::function<std::shared_ptr<Bot>()>;
+
+  /**
+   * @brief Configuration options for the matches
+   */
+  struct Config {
+    int32_t width{10};        ///< Board width
+    int32_t height{40};       ///< Board height
+    size_t previewSize{5};    ///< Pieces visible after the current one
+    size_t maxPieces{2000};   ///< Pieces per player before a draw
+    int32_t garbageDelay{1};  ///< Receiver placements before garbage lands
+    int32_t garbageCap{8};    ///< Rows inserted per placement
+    bool cancelGarbage{true}; ///< Whether attack cancels waiting garbage
+    AttackTable attackTable{
+        AttackTable::guideline()}; ///< Attack rules
+  };
+
+  /**
+   * @brief The outcome of one match
+   */
+  struct MatchResult {
+    uint64_t seed{0};                      ///< Seed of the match
+    int32_t winner{-1};                    ///< Winning player, -1 for a draw
+    std::array<size_t, 2> pieces{};        ///< Pieces placed by each player
+    std::array<int32_t, 2> attack{};       ///< Attack sent, after cancelling
+    std::array<int32_t, 2> linesCleared{}; ///< Lines cleared by each player
+  };
+
+  /**
+   * @brief Totals over several matches
+   */
+  struct Stats {
+    size_t matches{0};            ///< Matches played
+    std::array<size_t, 2> wins{}; ///< Matches won by each player
+    size_t draws{0};              ///< Matches reaching the piece limit
+    size_t pieces{0};             ///< Pieces placed by both players
+    double seconds{0.0};          ///< Wall-clock time spent
+
+    /**
+     * @brief Get the score rate of the first player, draws counting half
+     */
+    [[nodiscard]] double getFirstPlayerScore() const {
+      return matches > 0 ? (static_cast<double>(wins.at(0)) +
+                            0.5 * static_cast<double>(draws)) /
+                               static_cast<double>(matches)
+                         : 0.0;
+    }
+
+    /**
+     * @brief Get the number of pieces placed per second
+     */
+    [[nodiscard]] double getPiecesPerSecond() const {
+      return seconds > 0.0 ? static_cast<double>(pieces) / seconds : 0.0;
+    }
+  };
+
+  /**
+   * @brief Construct a versus simulator
+   *
+   * @param rotationSystem The rotation system of the games
+   * @param randomizer The randomizer, cloned for every player of every match
+   * @param firstBot Factory of the first player
+   * @param secondBot Factory of the second player
+   * @param config The match configuration
+   * @param executor The executor running matches in parallel, null to run
+   * them on the calling thread
+   * @throws std::invalid_argument if a pointer or factory is empty, the
+   * preview does not fit in a PieceQueue or garbageCap is not positive
+   */
+  VersusSimulator(std::shared_ptr<RotationSystem> rotationSystem,
+                  std::shared_ptr<Randomizer> randomizer, BotFactory firstBot,
+                  BotFactory secondBot, const Config& config,
+                  std::shared_ptr<WorkStealingExecutor> executor = nullptr);
+
+  /**
+   * @brief Play one match
+   *
+   * @param seed The seed of the piece sequence and garbage holes
+   * @return The outcome of the match
+   */
+  [[nodiscard]] MatchResult playMatch(uint64_t seed) const;
+
+  /**
+   * @brief Play one match per seed
+   *
+   * @param seeds The seeds of the matches
+   * @return The outcomes, in seed order
+   */
+  [[nodiscard]] std::vector<MatchResult>
+  playMatches(std::span<const uint64_t> seeds) const;
+
+  /**
+   * @brief Play one match per seed and total the outcomes
+   *
+   * @param seeds The seeds of the matches
+   * @return The totals
+   */
+  [[nodiscard]] Stats run(std::span<const uint64_t> seeds) const;
+
+  /**
+   * @brief Get the configuration options
+   */
+  [[nodiscard]] const Config& getConfig() const { return m_config; }
+
+private:
+  std::shared_ptr<RotationSystem> m_rotationSystem; ///< Rotation system
+  std::shared_ptr<Randomizer> m_randomizer;         ///< Randomizer prototype
+  std::array<BotFactory, 2> m_botFactories;         ///< Factories by player
+  Config m_config;                                  ///< Match configuration
+  std::shared_ptr<WorkStealingExecutor> m_executor; ///< Match executor
+};
+
+} // namespace tetris
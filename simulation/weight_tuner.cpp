@@ -0,0 +1,312 @@
+#include "weight_tuner.hpp"
+#include "../core/zobrist.hpp"
+#include "../randomizers/bag_randomizer.hpp"
+#include "../rotation_systems/rule_factory.hpp"
+#include "../search/search_factory.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace tetris {
+
+namespace {
+
+/**
+ * @brief First word of a checkpoint file, followed by its format version
+ */
+constexpr std::string_view checkpointMagic{"WeightTuner"};
+
+/**
+ * @brief Version of the checkpoint format
+ */
+constexpr int32_t checkpointVersion{1};
+
+/**
+ * @brief Mutation step of a weight near zero, relative to mutationScale
+ */
+constexpr double minimumMutationStep{0.1};
+
+/**
+ * @brief Write a number in its shortest form that reads back exactly
+ */
+void writeNumber(std::ofstream& file, const double value) {
+  std::array<char, 32> buffer{};
+  const auto [end, error]{
+      std::to_chars(buffer.data(), buffer.data() + buffer.size(), value)};
+  file.write(buffer.data(), end - buffer.data());
+}
+
+/**
+ * @brief Write a candidate as its fitness followed by its weights
+ */
+void writeCandidate(std::ofstream& file,
+                    const WeightTuner::Candidate& candidate) {
+  writeNumber(file, candidate.fitness);
+  for (const double weight : candidate.weights) {
+    file << ' ';
+    writeNumber(file, weight);
+  }
+  file << '\n';
+}
+
+/**
+ * @brief Read a candidate written by writeCandidate()
+ */
+void readCandidate(std::ifstream& file, WeightTuner::Candidate& candidate) {
+  file >> candidate.fitness;
+  for (double& weight : candidate.weights) {
+    file >> weight;
+  }
+}
+
+/**
+ * @brief Read a keyword and check it is the expected one
+ *
+ * @throws std::runtime_error if the file holds another word
+ */
+void expectWord(std::ifstream& file, const std::string_view expected) {
+  std::string word{};
+  file >> word;
+  [[unlikely]] if (word != expected) {
+    throw std::runtime_error("Malformed checkpoint: expected " +
+                             std::string{expected});
+  }
+}
+
+} // namespace
+
+WeightTuner::WeightTuner(std::shared_ptr<WorkStealingExecutor> executor)
+    : WeightTuner{Config{}, LinearEvaluator::defaultWeights,
+                  std::move(executor)} {}
+
+WeightTuner::WeightTuner(const Config& config, const Weights& initialWeights,
+                         std::shared_ptr<WorkStealingExecutor> executor)
+    : m_config{config}, m_randomState{config.seed},
+      m_executor{std::move(executor)} {
+  [[unlikely]] if (m_config.populationSize < 2 ||
+                   m_config.eliteCount >= m_config.populationSize ||
+                   m_config.gamesPerCandidate == 0 ||
+                   m_config.tournamentSize == 0) {
+    throw std::invalid_argument("Invalid tuner population parameters");
+  }
+
+  const auto rotationSystem{RuleFactory::getInstance().createRotationSystem(
+      m_config.rotationSystem)};
+  [[unlikely]] if (!rotationSystem) {
+    throw std::invalid_argument("Unknown rotation system: " +
+                                m_config.rotationSystem);
+  }
+  const std::shared_ptr<const SearchAlgorithm> movegen{
+      SearchFactory::getInstance().createSearchAlgorithm(m_config.movegen)};
+  [[unlikely]] if (!movegen) {
+    throw std::invalid_argument("Unknown move generator: " +
+                                m_config.movegen);
+  }
+
+  const size_t slotCount{m_executor ? m_executor->getThreadCount() + 1 : 1};
+  m_workers.resize(slotCount);
+  for (Worker& worker : m_workers) {
+    worker.evaluator = std::make_shared<LinearEvaluator>(initialWeights);
+    worker.bot = std::make_unique<BeamSearchBot>(std::make_shared<BeamSearch>(
+        movegen, worker.evaluator, AttackTable::guideline(), m_config.search));
+    worker.simulator = std::make_unique<Simulator>(
+        rotationSystem, std::make_shared<BagRandomizer>(), m_config.game);
+  }
+
+  // The initial weights are kept as they are, the others spread around them
+  m_population.resize(m_config.populationSize,
+                      Candidate{.weights = initialWeights});
+  for (size_t i{1}; i < m_population.size(); ++i) {
+    for (double& weight : m_population[i].weights) {
+      weight += m_config.mutationScale * (2.0 * drawUniform() - 1.0) *
+                (std::abs(weight) + minimumMutationStep);
+    }
+  }
+  m_best = m_population.front();
+}
+
+const WeightTuner::Candidate& WeightTuner::step() {
+  evaluatePopulation();
+  std::ranges::stable_sort(m_population,
+                           [](const Candidate& lhs, const Candidate& rhs) {
+                             return lhs.fitness > rhs.fitness;
+                           });
+  m_best = m_population.front();
+  ++m_generation;
+  breed();
+
+  if (!m_config.checkpointPath.empty()) {
+    saveCheckpoint(m_config.checkpointPath);
+  }
+  return m_best;
+}
+
+const WeightTuner::Candidate& WeightTuner::run(const size_t generations) {
+  for (size_t i{0}; i < generations; ++i) {
+    step();
+  }
+  return m_best;
+}
+
+void WeightTuner::saveCheckpoint(const std::string& path) const {
+  const std::string temporaryPath{path + ".tmp"};
+  {
+    std::ofstream file{temporaryPath, std::ios::trunc};
+    file << checkpointMagic << ' ' << checkpointVersion << '\n';
+    file << "generation " << m_generation << '\n';
+    file << "state " << m_randomState << '\n';
+    file << "weights " << featureCount << '\n';
+    file << "best ";
+    writeCandidate(file, m_best);
+    file << "population " << m_population.size() << '\n';
+    for (const Candidate& candidate : m_population) {
+      writeCandidate(file, candidate);
+    }
+    file.flush();
+    [[unlikely]] if (!file) {
+      throw std::runtime_error("Failed to write checkpoint " + temporaryPath);
+    }
+  }
+
+  std::error_code error{};
+  std::filesystem::rename(temporaryPath, path, error);
+  [[unlikely]] if (error) {
+    throw std::runtime_error("Failed to replace checkpoint " + path + ": " +
+                             error.message());
+  }
+}
+
+void WeightTuner::loadCheckpoint(const std::string& path) {
+  std::ifstream file{path};
+  [[unlikely]] if (!file) {
+    throw std::runtime_error("Failed to open checkpoint " + path);
+  }
+
+  int32_t version{0};
+  size_t generation{0};
+  uint64_t randomState{0};
+  size_t weightCount{0};
+  size_t populationSize{0};
+  expectWord(file, checkpointMagic);
+  file >> version;
+  expectWord(file, "generation");
+  file >> generation;
+  expectWord(file, "state");
+  file >> randomState;
+  expectWord(file, "weights");
+  file >> weightCount;
+  [[unlikely]] if (!file || version != checkpointVersion ||
+                   weightCount != featureCount) {
+    throw std::runtime_error("Incompatible checkpoint " + path);
+  }
+
+  Candidate best{};
+  expectWord(file, "best");
+  readCandidate(file, best);
+  expectWord(file, "population");
+  file >> populationSize;
+  [[unlikely]] if (!file || populationSize != m_config.populationSize) {
+    throw std::runtime_error("Incompatible checkpoint " + path);
+  }
+  std::vector<Candidate> population(populationSize);
+  for (Candidate& candidate : population) {
+    readCandidate(file, candidate);
+  }
+  [[unlikely]] if (!file) {
+    throw std::runtime_error("Truncated checkpoint " + path);
+  }
+
+  m_generation = generation;
+  m_randomState = randomState;
+  m_best = best;
+  m_population = std::move(population);
+}
+
+void WeightTuner::evaluatePopulation() {
+  // Every candidate plays the same seeds, which change every generation
+  uint64_t generationState{m_generation};
+  uint64_t seedState{m_config.seed ^ splitMix64(generationState)};
+  std::vector<uint64_t> seeds(m_config.gamesPerCandidate);
+  for (uint64_t& seed : seeds) {
+    seed = splitMix64(seedState);
+  }
+
+  const size_t gameCount{m_population.size() * seeds.size()};
+  std::vector<int64_t> scores(gameCount);
+  const auto play{[&](const size_t index) {
+    const size_t slot{m_executor ? m_executor->getCurrentSlot() : 0};
+    Worker& worker{m_workers[slot]};
+    worker.evaluator->setWeights(
+        m_population[index / seeds.size()].weights);
+    worker.simulator->playGame(*worker.bot, seeds[index % seeds.size()]);
+    scores[index] = worker.simulator->getGameState().getScore();
+  }};
+  if (m_executor) {
+    m_executor->parallelFor(gameCount, play);
+  } else {
+    for (size_t index{0}; index < gameCount; ++index) {
+      play(index);
+    }
+  }
+
+  for (size_t i{0}; i < m_population.size(); ++i) {
+    int64_t total{0};
+    for (size_t game{0}; game < seeds.size(); ++game) {
+      total += scores[i * seeds.size() + game];
+    }
+    m_population[i].fitness =
+        static_cast<double>(total) / static_cast<double>(seeds.size());
+  }
+}
+
+void WeightTuner::breed() {
+  std::vector<Candidate> offspring(m_population.begin(),
+                                   m_population.begin() +
+                                       static_cast<std::ptrdiff_t>(
+                                           m_config.eliteCount));
+  offspring.reserve(m_population.size());
+
+  while (offspring.size() < m_population.size()) {
+    const Candidate& first{selectParent()};
+    const Candidate& second{selectParent()};
+    Candidate child{};
+    for (size_t i{0}; i < featureCount; ++i) {
+      double weight{drawUniform() < 0.5 ? first.weights[i]
+                                        : second.weights[i]};
+      if (drawUniform() < m_config.mutationRate) {
+        weight += m_config.mutationScale * (2.0 * drawUniform() - 1.0) *
+                  (std::abs(weight) + minimumMutationStep);
+      }
+      child.weights[i] = weight;
+    }
+    offspring.push_back(child);
+  }
+
+  for (Candidate& candidate : offspring) {
+    candidate.fitness = 0.0;
+  }
+  m_population = std::move(offspring);
+}
+
+const WeightTuner::Candidate& WeightTuner::selectParent() {
+  // The population is sorted, so the lowest index drawn is the fittest
+  size_t winner{m_population.size()};
+  for (size_t i{0}; i < m_config.tournamentSize; ++i) {
+    const auto index{static_cast<size_t>(
+        drawUniform() * static_cast<double>(m_population.size()))};
+    winner = std::min(winner, index);
+  }
+  return m_population[winner];
+}
+
+double WeightTuner::drawUniform() {
+  return static_cast<double>(splitMix64(m_randomState) >> 11) * 0x1.0p-53;
+}
+
+} // namespace tetris
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "../evaluation/linear_evaluator.hpp"
+#include "../search/beam_search.hpp"
+#include "../search/work_stealing_executor.hpp"
+#include "beam_search_bot.hpp"
+#include "simulator.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tetris {
+
+/**
+ * @class WeightTuner
+ * @brief Genetic algorithm tuning the weights of a LinearEvaluator by
+ * self-play
+ *
+ * Every generation, each candidate weight vector plays the same headless
+ * games and its fitness is its mean game score. Games stop at the piece
+ * limit of the game configuration, so lines cleared would tie every
+ * candidate that survives; the score still separates them by how well they
+ * clear, rewarding tetrises, spins, back-to-back and combos. The elites are
+ * copied to the next generation unchanged, and the rest of it is bred from
+ * tournament-selected parents by uniform crossover and mutation. Elites are
+ * played again on the seeds of the next generation, so a lucky candidate
+ * does not stay on top.
+ *
+ * Games of all candidates run in parallel on an executor. Every thread slot
+ * keeps its own simulator and bot, and only the evaluator weights change from
+ * game to game, so the search arena and scratch states are reused; a search
+ * still allocates the landing lists of the nodes it expands.
+ *
+ * The state of the tuner depends only on the configuration and the
+ * generation, never on the number of threads. After every generation it is
+ * written to the checkpoint file, if one is set, and a run resumed from a
+ * checkpoint continues exactly as the interrupted one would have.
+ */
+class WeightTuner {
+public:
+  using Weights = LinearEvaluator::Weights;
+
+  /**
+   * @brief Configuration options for the tuner
+   */
+  struct Config {
+    std::string rotationSystem{"SRS"}; ///< Name in RuleFactory
+    std::string movegen{"PathSearch"}; ///< Name in SearchFactory
+    BeamSearch::Config search{
+        .beamWidth = 8, .depth = 2};   ///< Search of the candidates
+    Simulator::Config game{
+        .maxPieces = 500};             ///< Rules and piece cap of a game
+    size_t populationSize{32};         ///< Candidates per generation
+    size_t gamesPerCandidate{4};       ///< Games played by every candidate
+    size_t eliteCount{4};              ///< Best candidates kept unchanged
+    size_t tournamentSize{3};          ///< Candidates drawn to pick a parent
+    double mutationRate{0.25};         ///< Probability to mutate a weight
+    double mutationScale{0.2};         ///< Relative size of a mutation
+    uint64_t seed{0};                  ///< Seed of the games and breeding
+    std::string checkpointPath{};      ///< File written every generation
+  };
+
+  /**
+   * @brief A candidate weight vector
+   */
+  struct Candidate {
+    Weights weights{};   ///< Evaluator weights
+    double fitness{0.0}; ///< Mean score per game
+  };
+
+  /**
+   * @brief Construct a tuner with the default configuration and a population
+   * spread around the default weights
+   *
+   * @param executor The executor running games, null to run them on the
+   * calling thread
+   * @throws std::invalid_argument if a factory name is not registered
+   */
+  explicit WeightTuner(std::shared_ptr<WorkStealingExecutor> executor =
+                           nullptr);
+
+  /**
+   * @brief Construct a tuner with a population spread around initial weights
+   *
+   * @param config The tuner configuration
+   * @param initialWeights The weights the population starts around
+   * @param executor The executor running games, null to run them on the
+   * calling thread
+   * @throws std::invalid_argument if a factory name is not registered, or
+   * the population parameters are out of range
+   */
+  WeightTuner(const Config& config, const Weights& initialWeights,
+              std::shared_ptr<WorkStealingExecutor> executor = nullptr);
+
+  /**
+   * @brief Evaluate the current generation and breed the next one
+   *
+   * Writes the checkpoint afterwards if a checkpoint path is set.
+   *
+   * @return The best candidate of the evaluated generation
+   * @throws std::runtime_error if the checkpoint cannot be written
+   */
+  const Candidate& step();
+
+  /**
+   * @brief Run several generations
+   *
+   * @param generations The number of generations
+   * @return The best candidate of the last generation
+   * @throws std::runtime_error if a checkpoint cannot be written
+   */
+  const Candidate& run(size_t generations);
+
+  /**
+   * @brief Write the population and breeding state to a file
+   *
+   * The file is written next to the target and then renamed over it, so an
+   * interrupted write never leaves a truncated checkpoint.
+   *
+   * @param path The checkpoint file
+   * @throws std::runtime_error if the file cannot be written
+   */
+  void saveCheckpoint(const std::string& path) const;
+
+  /**
+   * @brief Restore the population and breeding state from a file
+   *
+   * @param path The checkpoint file
+   * @throws std::runtime_error if the file cannot be read, is malformed or
+   * holds another population size or number of weights
+   */
+  void loadCheckpoint(const std::string& path);
+
+  /**
+   * @brief Get the number of generations evaluated
+   */
+  [[nodiscard]] size_t getGeneration() const { return m_generation; }
+
+  /**
+   * @brief Get the candidates of the generation to evaluate next
+   */
+  [[nodiscard]] const std::vector<Candidate>& getPopulation() const {
+    return m_population;
+  }
+
+  /**
+   * @brief Get the best candidate of the last evaluated generation
+   */
+  [[nodiscard]] const Candidate& getBest() const { return m_best; }
+
+  /**
+   * @brief Get the configuration options
+   */
+  [[nodiscard]] const Config& getConfig() const { return m_config; }
+
+private:
+  /**
+   * @brief Simulator and bot of one thread slot
+   */
+  struct Worker {
+    std::shared_ptr<LinearEvaluator> evaluator; ///< Weights of the game
+    std::unique_ptr<BeamSearchBot> bot;         ///< Player
+    std::unique_ptr<Simulator> simulator;       ///< Game driver
+  };
+
+  /**
+   * @brief Play the games of every candidate and set their fitness
+   */
+  void evaluatePopulation();
+
+  /**
+   * @brief Replace the population by its offspring
+   *
+   * The population must be sorted best first.
+   */
+  void breed();
+
+  /**
+   * @brief Pick the fittest of tournamentSize random candidates
+   */
+  [[nodiscard]] const Candidate& selectParent();
+
+  /**
+   * @brief Draw a number uniformly in [0, 1) from the breeding state
+   */
+  [[nodiscard]] double drawUniform();
+
+  Config m_config;                                  ///< Tuner configuration
+  std::vector<Candidate> m_population;              ///< Current generation
+  Candidate m_best;                                 ///< Best of the last one
+  size_t m_generation{0};                           ///< Generations evaluated
+  uint64_t m_randomState{0};                        ///< Breeding random state
+  std::vector<Worker> m_workers;                    ///< One per thread slot
+  std::shared_ptr<WorkStealingExecutor> m_executor; ///< Game executor
+};
+
+} // namespace tetris